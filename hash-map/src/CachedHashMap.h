@@ -0,0 +1,186 @@
+#ifndef CPPHASHMAP_CACHEDHASHMAP_H
+#define CPPHASHMAP_CACHEDHASHMAP_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional> // std::hash
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "HashMap.h"
+
+/**
+ * @file CachedHashMap.h
+ * @brief HashMap with a small hot-key cache in front of the bucket table.
+ *
+ * For skewed (Zipf-like) access, where a few keys take most of the get()
+ * traffic. A 2-way set-associative cache of (hash, node) pairs, 16 bytes
+ * per way and 8 KB by default, sits in front of the table:
+ *
+ *     set = mix(hash) & (sets - 1)
+ *     | hash | node* | hash | node* |   way 0 = most recently used
+ *
+ * get() looks at the two ways of the key's set first and reads the key and
+ * value from the cached node, so a hot key costs one hash, one L1 line and
+ * its own node: no bucket load and no chain walk. A key found in the table
+ * replaces way 1 and moves to way 0 on its next hit, so keys seen once
+ * pass through way 1 without evicting the hot key of the set.
+ *
+ * HashMap nodes keep their address until they are removed, through puts
+ * and resizes, so the cache needs no update when values change or the
+ * table grows. remove() drops the key's way before the node is freed;
+ * clear() and reset() drop everything, since clear() recycles nodes.
+ *
+ * It pays off when the walk it skips is expensive: long chains or a costly
+ * key compare. With short chains the CPU caches already hold the hot nodes.
+ * get() writes the cache, so unlike HashMap::get() it is not safe to call
+ * from several threads at once.
+ */
+
+template <typename K, typename V>
+class CachedHashMap
+{
+    using Internals = HashMapInternals<K, V, 0>;
+
+    struct Way
+    {
+        size_t hash;
+
+        /// Cached node, nullptr for an empty way
+        const Node<K, V> *node;
+    };
+
+    struct Set
+    {
+        Way ways[2];
+    };
+
+    HashMap<K, V> map;
+
+    /// Cache sets, a power of two; mutable because get() fills them
+    mutable std::vector<Set> cache;
+
+    std::hash<K> hasher;
+
+    /// Spreads integer hashes (std::hash is the identity) over the sets
+    [[nodiscard]] Set &setOf(const size_t h) const
+    {
+        const uint64_t m = static_cast<uint64_t>(h) * 0x9e3779b97f4a7c15ull;
+        return cache[(m >> 32) & (cache.size() - 1)];
+    }
+
+    [[nodiscard]] const Node<K, V> *findNode(const K &key, const size_t h) const
+    {
+        const Node<K, V> *const *buckets = Internals::buckets(map);
+        if (!buckets) return nullptr;
+        for (const Node<K, V> *e = buckets[h & (Internals::capacity(map) - 1)]; e; e = e->next)
+        {
+            if (e->hash == h && e->key == key) return e;
+        }
+        return nullptr;
+    }
+
+    static std::optional<V> valueOf(const Node<K, V> *e)
+    {
+        if (!e) return std::nullopt;
+        return std::optional<V>(e->value);
+    }
+
+    void dropAll()
+    {
+        std::fill(cache.begin(), cache.end(), Set{});
+    }
+
+public:
+    /// Cache of @p cache_entries ways (rounded up to a power of two, at least 2);
+    /// a moved-from map works without a cache
+    explicit CachedHashMap(const size_t cache_entries = 512)
+        : cache(std::bit_ceil(std::max<size_t>(cache_entries, 2)) / 2) {}
+
+    CachedHashMap(const CachedHashMap&) = delete;
+    CachedHashMap& operator=(const CachedHashMap&) = delete;
+
+    CachedHashMap(CachedHashMap&&) noexcept = default;
+    CachedHashMap& operator=(CachedHashMap&&) noexcept = default;
+
+    /**
+     * @brief Same semantics as HashMap::get(); hot keys are served from the cache.
+     *
+     * @warning get() is const but fills and reorders the cache, so
+     *          concurrent get() calls need external synchronization.
+     */
+    [[nodiscard]] std::optional<V> get(const K &key) const
+    {
+        if (map.empty()) return std::nullopt;
+        const size_t h = hasher(key);
+        if (cache.empty()) return valueOf(findNode(key, h));
+        Set &set = setOf(h);
+        if (set.ways[0].hash == h && set.ways[0].node && set.ways[0].node->key == key)
+        {
+            return std::optional<V>(set.ways[0].node->value);
+        }
+        if (set.ways[1].hash == h && set.ways[1].node && set.ways[1].node->key == key)
+        {
+            std::swap(set.ways[0], set.ways[1]);
+            return std::optional<V>(set.ways[0].node->value);
+        }
+        // New keys enter way 1, so a stream of cold keys cannot evict way 0
+        const Node<K, V> *e = findNode(key, h);
+        if (e) set.ways[1] = {h, e};
+        return valueOf(e);
+    }
+
+    /// Same semantics as HashMap::put(); cached nodes see the new value
+    void put(const K &key, const V &value)
+    {
+        map.put(key, value);
+    }
+
+    /// Same semantics as HashMap::remove(); drops the key from the cache
+    bool remove(const K &key)
+    {
+        if (map.empty() || cache.empty()) return map.remove(key);
+        const size_t h = hasher(key);
+        Set &set = setOf(h);
+        for (Way &way : set.ways)
+        {
+            if (way.hash == h && way.node && way.node->key == key) way = {};
+        }
+        return map.remove(key);
+    }
+
+    /// Removes all elements and empties the cache
+    void clear()
+    {
+        dropAll();
+        map.clear();
+    }
+
+    /// Removes all elements, frees the table and empties the cache
+    void reset()
+    {
+        dropAll();
+        map.reset();
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return map.size();
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return map.empty();
+    }
+
+    /// Calls fn(key, value) for every element, in unspecified order
+    template <typename F>
+    void forEach(F &&fn) const
+    {
+        map.forEach(fn);
+    }
+};
+
+#endif //CPPHASHMAP_CACHEDHASHMAP_H
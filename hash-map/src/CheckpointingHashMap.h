@@ -0,0 +1,270 @@
+#ifndef CPPHASHMAP_CHECKPOINTINGHASHMAP_H
+#define CPPHASHMAP_CHECKPOINTINGHASHMAP_H
+
+#include <cstdint>
+#include <cstdio>
+#include <functional> // std::hash
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "HashMap.h"
+#include "Serialization.h"
+
+/**
+ * @file CheckpointingHashMap.h
+ * @brief Thread-safe HashMap with background point-in-time snapshots.
+ *
+ * checkpoint() starts a writer thread that streams the table to a file in
+ * the HashMap::save() format (readable with HashMap::load()) while
+ * get/put/remove keep running.
+ *
+ * Copy-on-write at bucket granularity: the writer copies one bucket at a
+ * time under the lock and advances its progress marker. Before a mutation
+ * touches a bucket the writer has not reached yet, the bucket's entries as
+ * of the checkpoint are copied aside, and the writer uses that copy
+ * instead. Each bucket is copied at most once, so for plain updates,
+ * inserts and removes the extra memory is bounded by the checkpointed
+ * entries that are modified before they are written, plus a flag and an
+ * empty vector per bucket.
+ *
+ * A mutation that would resize or clear the table first preserves every
+ * bucket the writer has not reached yet. In the worst case (a resize or
+ * clear() right after checkpoint()) that is a copy of the whole table, so
+ * peak memory during a checkpoint may be twice the size of the map.
+ *
+ * All operations take a single mutex, held only for one map operation or
+ * one bucket copy; file I/O runs outside of it. checkpoint() and
+ * waitCheckpoint() are meant to be called from one controlling thread.
+ */
+
+template <typename K, typename V>
+class CheckpointingHashMap
+{
+    using Internals = HashMapInternals<K, V, 0>;
+
+    struct Entry
+    {
+        size_t hash;
+        K key;
+        V value;
+    };
+
+    /// State of the running checkpoint, guarded by lock
+    struct Checkpoint
+    {
+        /// Capacity at the time of the checkpoint
+        size_t capacity = 0;
+
+        /// Buckets [0, written) are already copied by the writer
+        size_t written = 0;
+
+        /// Every bucket from written on has been preserved
+        bool all_preserved = false;
+
+        std::vector<char> preserved;
+        std::vector<std::vector<Entry>> saved;
+    };
+
+    HashMap<K, V> map;
+
+    mutable std::mutex lock;
+
+    std::hash<K> hasher;
+
+    /// Present while a checkpoint is running
+    std::optional<Checkpoint> active;
+
+    std::thread writer;
+
+    /// Result of the last finished checkpoint
+    bool last_ok = true;
+
+    /// Copies the chain of bucket @p index as it is now
+    std::vector<Entry> copyBucket(const size_t index) const
+    {
+        std::vector<Entry> entries;
+        const Node<K, V> *const *buckets = Internals::buckets(map);
+        if (!buckets) return entries;
+        for (const Node<K, V> *e = buckets[index]; e; e = e->next)
+        {
+            entries.push_back({e->hash, e->key, e->value});
+        }
+        return entries;
+    }
+
+    void preserve(Checkpoint &cp, const size_t index)
+    {
+        if (index < cp.written || cp.preserved[index]) return;
+        cp.saved[index] = copyBucket(index);
+        cp.preserved[index] = 1;
+    }
+
+    void preserveAll(Checkpoint &cp)
+    {
+        for (size_t i = cp.written; i < cp.capacity; ++i)
+        {
+            preserve(cp, i);
+        }
+        cp.all_preserved = true;
+    }
+
+    /// Called under lock before a mutation of @p key
+    void beforeMutation(const K &key, const bool may_insert)
+    {
+        if (!active || active->all_preserved) return;
+        Checkpoint &cp = *active;
+        if (may_insert && map.size() + 1 > Internals::threshold(map) && !map.get(key))
+        {
+            preserveAll(cp);
+            return;
+        }
+        preserve(cp, hasher(key) & (cp.capacity - 1));
+    }
+
+    /// Writer thread body
+    bool writeCheckpoint(const std::string &path, const uint64_t count, const float load_factor)
+    {
+        const std::string tmp = path + ".tmp";
+        BinaryWriter out(tmp);
+        out.writeBytes(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        out.writePod(SNAPSHOT_VERSION);
+
+        size_t capacity;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            capacity = active->capacity;
+        }
+        out.writePod(static_cast<uint64_t>(capacity));
+        out.writePod(count);
+        out.writePod(load_factor);
+
+        std::vector<Entry> entries;
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                Checkpoint &cp = *active;
+                if (cp.preserved[i])
+                {
+                    entries = std::move(cp.saved[i]);
+                    std::vector<Entry>().swap(cp.saved[i]);
+                }
+                else
+                {
+                    entries = copyBucket(i);
+                }
+                cp.written = i + 1;
+            }
+            for (const Entry &e : entries)
+            {
+                out.writePod(static_cast<uint64_t>(e.hash));
+                Codec<K>::write(out, e.key);
+                Codec<V>::write(out, e.value);
+            }
+        }
+        return out.close() && std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+
+public:
+    CheckpointingHashMap() = default;
+
+    CheckpointingHashMap(const CheckpointingHashMap&) = delete;
+    CheckpointingHashMap& operator=(const CheckpointingHashMap&) = delete;
+
+    ~CheckpointingHashMap()
+    {
+        waitCheckpoint();
+    }
+
+    [[nodiscard]] std::optional<V> get(const K &key) const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return map.get(key);
+    }
+
+    void put(const K &key, const V &value)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        beforeMutation(key, true);
+        map.put(key, value);
+    }
+
+    bool remove(const K &key)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        beforeMutation(key, false);
+        return map.remove(key);
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (active && !active->all_preserved) preserveAll(*active);
+        map.clear();
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return map.size();
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Starts writing a snapshot of the current contents to @p path.
+     *
+     * Returns immediately; the file is written to `path + ".tmp"` on a
+     * background thread and renamed to @p path when complete.
+     *
+     * @return false if a checkpoint is already running
+     */
+    bool checkpoint(const std::string &path)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (active) return false;
+        if (writer.joinable()) writer.join();
+
+        Checkpoint &cp = active.emplace();
+        cp.capacity = Internals::capacity(map);
+        cp.preserved.assign(cp.capacity, 0);
+        cp.saved.resize(cp.capacity);
+        const uint64_t count = map.size();
+        const float load_factor = Internals::loadFactor(map);
+        writer = std::thread([this, path, count, load_factor]
+        {
+            const bool written = writeCheckpoint(path, count, load_factor);
+            std::lock_guard<std::mutex> done(lock);
+            last_ok = written;
+            active.reset();
+        });
+        return true;
+    }
+
+    /**
+     * @brief Waits for the running checkpoint, if any.
+     *
+     * @return true if the last checkpoint was written successfully
+     */
+    bool waitCheckpoint()
+    {
+        if (writer.joinable()) writer.join();
+        std::lock_guard<std::mutex> guard(lock);
+        return last_ok;
+    }
+
+    [[nodiscard]] bool checkpointRunning() const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return active.has_value();
+    }
+};
+
+#endif //CPPHASHMAP_CHECKPOINTINGHASHMAP_H
@@ -0,0 +1,256 @@
+#ifndef CPPHASHMAP_COLUMNARHASHMAP_H
+#define CPPHASHMAP_COLUMNARHASHMAP_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional> // std::hash
+#include <optional>
+#include <utility>
+#include <vector>
+
+/**
+ * @file ColumnarHashMap.h
+ * @brief Open-addressing hash map in structure-of-arrays layout.
+ *
+ * The table is three parallel arrays of the same capacity (a power of two)
+ * plus an occupancy bitmap with one bit per slot:
+ *
+ *     hashes   | h0 | 0  | h2 | h3 | 0  | ...
+ *     keys     | k0 |    | k2 | k3 |    | ...
+ *     values   | v0 |    | v2 | v3 |    | ...
+ *     occupied |  1 |  0 |  1 |  1 |  0 | ...
+ *
+ * The stored hash is std::hash mixed by a Fibonacci multiply (std::hash of
+ * an integer is the identity), so keys that share their low bits do not
+ * pile up in one probe run. A stored hash of 0 marks a free slot (a mixed
+ * hash of 0 is stored as 1).
+ * Lookups probe linearly through the hashes array alone and touch keys
+ * only on a hash match, so a probe sequence is one contiguous run of
+ * 8-byte words. Scans (forEach(), forEachValue()) walk the set bits of the
+ * bitmap and load only the occupied values, so a value scan reads 1 bit per
+ * slot instead of an 8-byte hash and has no per-slot branch to mispredict.
+ *
+ * remove() shifts the following entries back instead of leaving
+ * tombstones. The table doubles once size exceeds 0.75 x capacity.
+ * K and V must be default constructible.
+ */
+
+template <typename K, typename V>
+class ColumnarHashMap
+{
+    static constexpr size_t MIN_CAPACITY = 16;
+
+    std::vector<size_t> hashes;
+    std::vector<K> keys;
+    std::vector<V> values;
+    /// Bit i % 64 of word i / 64 is set when slot i holds an entry
+    std::vector<uint64_t> occupied;
+
+    size_t sz = 0;
+
+    std::hash<K> hasher;
+
+    /// Hash as stored in the table, never 0; its low bits depend on every bit of the key
+    [[nodiscard]] size_t storedHash(const K &key) const
+    {
+        uint64_t m = static_cast<uint64_t>(hasher(key)) * 0x9e3779b97f4a7c15ull;
+        m ^= m >> 32;
+        return m ? static_cast<size_t>(m) : 1;
+    }
+
+    /// Returns the slot of @p key or the free slot where it belongs
+    [[nodiscard]] size_t probe(const K &key, const size_t h) const
+    {
+        const size_t mask = hashes.size() - 1;
+        const size_t *hs = hashes.data();
+        size_t i = h & mask;
+        for (;; i = (i + 1) & mask)
+        {
+            if (hs[i] == 0) return i;
+            if (hs[i] == h && keys[i] == key) return i;
+        }
+    }
+
+    void markOccupied(const size_t i)
+    {
+        occupied[i >> 6] |= uint64_t{1} << (i & 63);
+    }
+
+    void markFree(const size_t i)
+    {
+        occupied[i >> 6] &= ~(uint64_t{1} << (i & 63));
+    }
+
+    /// Doubles the arrays and reinserts every entry
+    void grow()
+    {
+        const size_t cap = std::max(MIN_CAPACITY, hashes.size() * 2);
+        std::vector<size_t> old_hashes = std::exchange(hashes, std::vector<size_t>(cap, 0));
+        std::vector<K> old_keys = std::exchange(keys, std::vector<K>(cap));
+        std::vector<V> old_values = std::exchange(values, std::vector<V>(cap));
+        occupied.assign((cap + 63) / 64, 0);
+        const size_t mask = hashes.size() - 1;
+        for (size_t j = 0; j < old_hashes.size(); ++j)
+        {
+            if (old_hashes[j] == 0) continue;
+            size_t i = old_hashes[j] & mask;
+            while (hashes[i] != 0) i = (i + 1) & mask;
+            hashes[i] = old_hashes[j];
+            keys[i] = std::move(old_keys[j]);
+            values[i] = std::move(old_values[j]);
+            markOccupied(i);
+        }
+    }
+
+public:
+    ColumnarHashMap() = default;
+
+    ColumnarHashMap(const ColumnarHashMap&) = delete;
+    ColumnarHashMap& operator=(const ColumnarHashMap&) = delete;
+
+    ColumnarHashMap(ColumnarHashMap &&other) noexcept
+        : hashes(std::move(other.hashes)),
+          keys(std::move(other.keys)),
+          values(std::move(other.values)),
+          occupied(std::move(other.occupied)),
+          sz(std::exchange(other.sz, 0))
+    {
+        other.reset();
+    }
+
+    ColumnarHashMap& operator=(ColumnarHashMap &&other) noexcept
+    {
+        if (this != &other)
+        {
+            hashes = std::move(other.hashes);
+            keys = std::move(other.keys);
+            values = std::move(other.values);
+            occupied = std::move(other.occupied);
+            sz = std::exchange(other.sz, 0);
+            other.reset();
+        }
+        return *this;
+    }
+
+    /// Same semantics as HashMap::get()
+    [[nodiscard]] std::optional<V> get(const K &key) const
+    {
+        if (sz == 0) return std::nullopt;
+        const size_t i = probe(key, storedHash(key));
+        if (hashes[i] == 0) return std::nullopt;
+        return std::optional<V>(values[i]);
+    }
+
+    /// Same semantics as HashMap::put()
+    void put(const K &key, const V &value)
+    {
+        const size_t h = storedHash(key);
+        if (!hashes.empty())
+        {
+            const size_t i = probe(key, h);
+            if (hashes[i] != 0)
+            {
+                values[i] = value;
+                return;
+            }
+        }
+        if (sz + 1 > hashes.size() / 4 * 3) grow();
+        const size_t i = probe(key, h);
+        hashes[i] = h;
+        keys[i] = key;
+        values[i] = value;
+        markOccupied(i);
+        ++sz;
+    }
+
+    /// Removes an element by key (backward-shift deletion)
+    bool remove(const K &key)
+    {
+        if (sz == 0) return false;
+        const size_t mask = hashes.size() - 1;
+        size_t hole = probe(key, storedHash(key));
+        if (hashes[hole] == 0) return false;
+
+        for (size_t i = (hole + 1) & mask; hashes[i] != 0; i = (i + 1) & mask)
+        {
+            // Entry i may fill the hole unless its home slot lies in (hole, i]
+            if (((i - hashes[i]) & mask) < ((i - hole) & mask)) continue;
+            hashes[hole] = hashes[i];
+            keys[hole] = std::move(keys[i]);
+            values[hole] = std::move(values[i]);
+            hole = i;
+        }
+        hashes[hole] = 0;
+        keys[hole] = K();
+        values[hole] = V();
+        markFree(hole);
+        --sz;
+        return true;
+    }
+
+    /// Removes all elements, keeps the arrays
+    void clear()
+    {
+        for (size_t i = 0; i < hashes.size(); ++i)
+        {
+            if (hashes[i] == 0) continue;
+            hashes[i] = 0;
+            keys[i] = K();
+            values[i] = V();
+        }
+        std::fill(occupied.begin(), occupied.end(), 0);
+        sz = 0;
+    }
+
+    /// Removes all elements and frees the arrays
+    void reset()
+    {
+        std::vector<size_t>().swap(hashes);
+        std::vector<K>().swap(keys);
+        std::vector<V>().swap(values);
+        std::vector<uint64_t>().swap(occupied);
+        sz = 0;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return sz;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return sz == 0;
+    }
+
+    /// Calls fn(key, value) for every element, in unspecified order
+    template <typename F>
+    void forEach(F &&fn) const
+    {
+        for (size_t w = 0; w < occupied.size(); ++w)
+        {
+            for (uint64_t bits = occupied[w]; bits != 0; bits &= bits - 1)
+            {
+                const size_t i = w * 64 + std::countr_zero(bits);
+                fn(keys[i], values[i]);
+            }
+        }
+    }
+
+    /// Calls fn(value) for every element without loading keys
+    template <typename F>
+    void forEachValue(F &&fn) const
+    {
+        const uint64_t *words = occupied.data();
+        const V *vs = values.data();
+        for (size_t w = 0; w < occupied.size(); ++w)
+        {
+            for (uint64_t bits = words[w]; bits != 0; bits &= bits - 1)
+            {
+                fn(vs[w * 64 + std::countr_zero(bits)]);
+            }
+        }
+    }
+};
+
+#endif //CPPHASHMAP_COLUMNARHASHMAP_H
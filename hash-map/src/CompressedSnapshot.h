@@ -0,0 +1,420 @@
+#ifndef CPPHASHMAP_COMPRESSEDSNAPSHOT_H
+#define CPPHASHMAP_COMPRESSEDSNAPSHOT_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "HashMap.h"
+#include "Serialization.h"
+
+/**
+ * @file CompressedSnapshot.h
+ * @brief Compact snapshot format for maps with integer keys.
+ *
+ * Entries are sorted by key and written in blocks of up to 128:
+ *
+ *     "HMSZ" | uint32 version | uint64 size | blocks
+ *     block = varint n | varint first key | uint8 width | packed key gaps
+ *             | values
+ *
+ * Keys are stored as gaps to the previous key (minus one, keys are unique)
+ * bit-packed with the smallest width that fits the largest gap of the
+ * block, so dense or near-sequential keys take a few bits each.
+ *
+ * Integer values (other than bool) use frame-of-reference per block:
+ * varint block minimum, uint8 width, then every value minus the minimum
+ * bit-packed. Other values are written with Codec<V>.
+ *
+ * Signed numbers are zigzag-encoded in varints. Hashes are not stored, the
+ * loader rehashes every key (std::hash of an integer is trivial) and links
+ * the nodes into a table that is allocated once for the final size.
+ */
+
+inline constexpr char COMPRESSED_MAGIC[4] = {'H', 'M', 'S', 'Z'};
+inline constexpr uint32_t COMPRESSED_VERSION = 1;
+
+namespace compressed_snapshot_detail
+{
+    inline constexpr size_t BLOCK_SIZE = 128;
+
+    /// Smallest possible block: varint n, varint first key, uint8 key width
+    inline constexpr size_t MIN_BLOCK_BYTES = 3;
+
+    /// Integer types that are delta or frame-of-reference encoded
+    template <typename T>
+    inline constexpr bool packable = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+    /// Maps an integer to uint64, zigzag for signed types
+    template <typename T>
+    uint64_t toUnsigned(const T value)
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            const auto v = static_cast<int64_t>(value);
+            return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+        }
+        else
+        {
+            return static_cast<uint64_t>(value);
+        }
+    }
+
+    template <typename T>
+    T fromUnsigned(const uint64_t value)
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            return static_cast<T>(static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1));
+        }
+        else
+        {
+            return static_cast<T>(value);
+        }
+    }
+
+    /// Difference b - a of two integers with a <= b, as uint64
+    template <typename T>
+    uint64_t distance(const T a, const T b)
+    {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<U>(static_cast<U>(b) - static_cast<U>(a));
+    }
+
+    template <typename T>
+    T advance(const T a, const uint64_t d)
+    {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(static_cast<U>(static_cast<U>(a) + static_cast<U>(d)));
+    }
+
+    /// Appends values of a fixed bit width to a byte vector, LSB first
+    class BitWriter
+    {
+        std::vector<char> &out;
+        uint64_t acc = 0;
+        unsigned bits = 0;
+
+        void put32(const uint64_t value, const unsigned width)
+        {
+            acc |= value << bits;
+            bits += width;
+            while (bits >= 8)
+            {
+                out.push_back(static_cast<char>(acc));
+                acc >>= 8;
+                bits -= 8;
+            }
+        }
+
+    public:
+        explicit BitWriter(std::vector<char> &o) : out(o) {}
+
+        void put(const uint64_t value, const unsigned width)
+        {
+            if (width > 32)
+            {
+                put32(value & 0xffffffffu, 32);
+                put32(value >> 32, width - 32);
+            }
+            else if (width != 0)
+            {
+                put32(value, width);
+            }
+        }
+
+        /// Writes the last partial byte
+        void finish()
+        {
+            if (bits != 0) out.push_back(static_cast<char>(acc));
+            acc = 0;
+            bits = 0;
+        }
+    };
+
+    /// Reads values written by BitWriter
+    class BitReader
+    {
+        const unsigned char *pos;
+        uint64_t acc = 0;
+        unsigned bits = 0;
+
+        uint64_t get32(const unsigned width)
+        {
+            while (bits < width)
+            {
+                acc |= static_cast<uint64_t>(*pos++) << bits;
+                bits += 8;
+            }
+            const uint64_t value = acc & ((uint64_t{1} << width) - 1);
+            acc >>= width;
+            bits -= width;
+            return value;
+        }
+
+    public:
+        explicit BitReader(const char *data) : pos(reinterpret_cast<const unsigned char *>(data)) {}
+
+        uint64_t get(const unsigned width)
+        {
+            if (width > 32)
+            {
+                const uint64_t low = get32(32);
+                return low | get32(width - 32) << 32;
+            }
+            return width ? get32(width) : 0;
+        }
+    };
+
+    inline size_t packedBytes(const size_t count, const unsigned width)
+    {
+        return (count * width + 7) / 8;
+    }
+}
+
+/**
+ * @brief Writes @p map to a compressed snapshot file.
+ *
+ * @param map map with an integral key type
+ * @param path file to create or truncate
+ * @return true if the whole snapshot was written
+ *
+ * @note Complexity is O(n log n + capacity), dominated by sorting.
+ */
+template <typename K, typename V, size_t N>
+bool saveCompressed(const HashMap<K, V, N> &map, const std::string &path)
+{
+    using namespace compressed_snapshot_detail;
+    static_assert(packable<K>, "compressed snapshots require integer keys");
+
+    std::vector<std::pair<K, const V *>> entries;
+    entries.reserve(map.size());
+    map.forEach([&](const K &key, const V &value)
+    {
+        entries.emplace_back(key, &value);
+    });
+    std::sort(entries.begin(), entries.end(), [](const auto &a, const auto &b)
+    {
+        return a.first < b.first;
+    });
+
+    BinaryWriter out(path);
+    out.writeBytes(COMPRESSED_MAGIC, sizeof(COMPRESSED_MAGIC));
+    out.writePod(COMPRESSED_VERSION);
+    out.writePod(static_cast<uint64_t>(entries.size()));
+
+    std::vector<char> packed;
+    for (size_t start = 0; start < entries.size(); start += BLOCK_SIZE)
+    {
+        const size_t n = std::min(BLOCK_SIZE, entries.size() - start);
+        const auto *block = entries.data() + start;
+        out.writeVarint(n);
+        out.writeVarint(toUnsigned(block[0].first));
+
+        uint64_t max_gap = 0;
+        for (size_t i = 1; i < n; ++i)
+        {
+            max_gap = std::max(max_gap, distance(block[i - 1].first, block[i].first) - 1);
+        }
+        const auto key_width = static_cast<uint8_t>(std::bit_width(max_gap));
+        out.writePod(key_width);
+        packed.clear();
+        BitWriter keys(packed);
+        for (size_t i = 1; i < n; ++i)
+        {
+            keys.put(distance(block[i - 1].first, block[i].first) - 1, key_width);
+        }
+        keys.finish();
+        out.writeBytes(packed.data(), packed.size());
+
+        if constexpr (packable<V>)
+        {
+            V min = *block[0].second;
+            V max = min;
+            for (size_t i = 1; i < n; ++i)
+            {
+                min = std::min(min, *block[i].second);
+                max = std::max(max, *block[i].second);
+            }
+            const auto value_width = static_cast<uint8_t>(std::bit_width(distance(min, max)));
+            out.writeVarint(toUnsigned(min));
+            out.writePod(value_width);
+            packed.clear();
+            BitWriter values(packed);
+            for (size_t i = 0; i < n; ++i)
+            {
+                values.put(distance(min, *block[i].second), value_width);
+            }
+            values.finish();
+            out.writeBytes(packed.data(), packed.size());
+        }
+        else
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                Codec<V>::write(out, *block[i].second);
+            }
+        }
+    }
+    return out.close();
+}
+
+/**
+ * @brief Replaces the contents of @p map with a snapshot written by saveCompressed().
+ *
+ * The bucket table is allocated once for the stored size and decoded nodes
+ * are linked directly into it, resize() is never called.
+ *
+ * The stored size is checked against the remaining file size before the
+ * table is allocated, and keys must strictly increase across the whole
+ * file, so a corrupt snapshot fails the load instead of throwing or
+ * linking duplicate keys.
+ *
+ * @param path compressed snapshot file
+ * @param map destination, emptied first
+ * @return true on success; on failure the map is left empty
+ *
+ * @note Complexity is O(n + capacity).
+ */
+template <typename K, typename V, size_t N>
+bool loadCompressed(const std::string &path, HashMap<K, V, N> &map)
+{
+    using NodeT = Node<K, V>;
+    using Internals = HashMapInternals<K, V, N>;
+    using namespace compressed_snapshot_detail;
+    static_assert(packable<K>, "compressed snapshots require integer keys");
+
+    map.reset();
+    BinaryReader in(path);
+    char magic[sizeof(COMPRESSED_MAGIC)];
+    uint32_t version = 0;
+    uint64_t count = 0;
+    if (!in.readBytes(magic, sizeof(magic))
+        || !std::equal(magic, magic + sizeof(magic), COMPRESSED_MAGIC)
+        || !in.readPod(version) || version != COMPRESSED_VERSION
+        || !in.readPod(count)
+        || count / BLOCK_SIZE + (count % BLOCK_SIZE != 0) > in.remaining() / MIN_BLOCK_BYTES)
+    {
+        return false;
+    }
+
+    // Small maps go through put() to stay inline
+    const bool bulk = N == 0 || count > N;
+    NodeT **buckets = bulk ? Internals::prepare(map, count) : nullptr;
+    const size_t capacity = Internals::capacity(map);
+    const std::hash<K> hasher;
+
+    // Packed bytes of a block, with room for the widest (64-bit) values
+    std::vector<char> packed;
+    std::vector<K> keys(BLOCK_SIZE);
+    // Last key of the previous block
+    K last{};
+    size_t loaded = 0;
+    size_t linked = 0;
+    bool good = true;
+    while (good && loaded < count)
+    {
+        uint64_t n = 0;
+        uint64_t first = 0;
+        uint8_t key_width = 0;
+        if (!in.readVarint(n) || n == 0 || n > BLOCK_SIZE || n > count - loaded
+            || !in.readVarint(first) || !in.readPod(key_width) || key_width > 64)
+        {
+            good = false;
+            break;
+        }
+        packed.resize(packedBytes(n - 1, key_width));
+        if (!in.readBytes(packed.data(), packed.size()))
+        {
+            good = false;
+            break;
+        }
+        keys[0] = fromUnsigned<K>(first);
+        if (toUnsigned(keys[0]) != first || (loaded != 0 && !(last < keys[0])))
+        {
+            good = false;
+            break;
+        }
+        BitReader key_bits(packed.data());
+        for (size_t i = 1; i < n && good; ++i)
+        {
+            // The gap must not step past the largest key
+            const uint64_t gap = key_bits.get(key_width);
+            if (gap >= distance(keys[i - 1], std::numeric_limits<K>::max()))
+            {
+                good = false;
+                break;
+            }
+            keys[i] = advance(keys[i - 1], gap + 1);
+        }
+        if (!good) break;
+        last = keys[n - 1];
+
+        auto emit = [&](const K key, V &&value)
+        {
+            if (!bulk)
+            {
+                map.put(key, value);
+                return;
+            }
+            const size_t h = hasher(key);
+            NodeT *&head = buckets[h & (capacity - 1)];
+            head = new NodeT(K(key), std::move(value), h, head);
+            ++linked;
+        };
+
+        if constexpr (packable<V>)
+        {
+            uint64_t min = 0;
+            uint8_t value_width = 0;
+            if (!in.readVarint(min) || !in.readPod(value_width) || value_width > 64)
+            {
+                good = false;
+                break;
+            }
+            packed.resize(packedBytes(n, value_width));
+            if (!in.readBytes(packed.data(), packed.size()))
+            {
+                good = false;
+                break;
+            }
+            BitReader value_bits(packed.data());
+            const V base = fromUnsigned<V>(min);
+            for (size_t i = 0; i < n; ++i)
+            {
+                emit(keys[i], advance(base, value_bits.get(value_width)));
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < n && good; ++i)
+            {
+                V value{};
+                if (!Codec<V>::read(in, value))
+                {
+                    good = false;
+                    break;
+                }
+                emit(keys[i], std::move(value));
+            }
+        }
+        loaded += n;
+    }
+
+    if (!good)
+    {
+        // Linked nodes are owned by the map once the size is set
+        if (bulk) Internals::setSize(map, linked);
+        map.reset();
+        return false;
+    }
+    if (bulk) Internals::setSize(map, count);
+    return true;
+}
+
+#endif //CPPHASHMAP_COMPRESSEDSNAPSHOT_H
@@ -0,0 +1,145 @@
+#ifndef CPPHASHMAP_CONTIGUOUSHASHMAP_H
+#define CPPHASHMAP_CONTIGUOUSHASHMAP_H
+
+#include <bit>
+#include <cstdint>
+#include <functional> // std::hash
+#include <optional>
+#include <vector>
+
+#include "HashMap.h"
+
+/**
+ * @file ContiguousHashMap.h
+ * @brief Immutable bucket-ordered copy of a HashMap (CSR layout).
+ *
+ * ContiguousHashMap::freeze() copies every entry into one array sorted by
+ * bucket index. Bucket i becomes the range [offsets[i], offsets[i + 1]):
+ *
+ *     offsets | 0 | 2 | 2 | 3 | ... | size
+ *     entries | b0 | b0 | b2 | ...
+ *
+ * A lookup computes the bucket as in HashMap and scans a contiguous run,
+ * comparing cached hashes first, instead of following Node::next.
+ *
+ * Building reuses the bucket table and the cached hashes of the source,
+ * walking it in bucket order: O(n + capacity), no hashing, no sorting.
+ * Chain order is kept within each bucket.
+ */
+
+template <typename K, typename V>
+class ContiguousHashMap
+{
+    struct Entry
+    {
+        size_t hash;
+        K key;
+        V value;
+    };
+
+    /// Start of every bucket's range in entries, capacity + 1 elements
+    std::vector<size_t> offsets;
+
+    /// Entries sorted by bucket index
+    std::vector<Entry> entries;
+
+    std::hash<K> hasher;
+
+public:
+    ContiguousHashMap() = default;
+
+    ContiguousHashMap(ContiguousHashMap&&) noexcept = default;
+    ContiguousHashMap& operator=(ContiguousHashMap&&) noexcept = default;
+
+    ContiguousHashMap(const ContiguousHashMap&) = delete;
+    ContiguousHashMap& operator=(const ContiguousHashMap&) = delete;
+
+    /**
+     * @brief Builds an immutable copy of @p map.
+     *
+     * @note Complexity is O(n + capacity), the source is left unchanged.
+     */
+    template <size_t N>
+    static ContiguousHashMap freeze(const HashMap<K, V, N> &map)
+    {
+        using Internals = HashMapInternals<K, V, N>;
+        ContiguousHashMap frozen;
+        const size_t n = map.size();
+        if (n == 0) return frozen;
+        frozen.entries.reserve(n);
+
+        const Node<K, V> *const *buckets = Internals::buckets(map);
+        if (buckets)
+        {
+            // Walking the table in order yields entries sorted by bucket
+            const size_t capacity = Internals::capacity(map);
+            frozen.offsets.reserve(capacity + 1);
+            for (size_t i = 0; i < capacity; ++i)
+            {
+                frozen.offsets.push_back(frozen.entries.size());
+                for (const Node<K, V> *e = buckets[i]; e; e = e->next)
+                {
+                    frozen.entries.push_back({e->hash, e->key, e->value});
+                }
+            }
+            frozen.offsets.push_back(frozen.entries.size());
+            return frozen;
+        }
+
+        // Small map stored inline: no table to reuse, counting sort by bucket
+        const size_t capacity = std::bit_ceil(n);
+        std::vector<Entry> unsorted;
+        unsorted.reserve(n);
+        frozen.offsets.assign(capacity + 1, 0);
+        map.forEach([&](const K &key, const V &value)
+        {
+            const size_t h = frozen.hasher(key);
+            unsorted.push_back({h, key, value});
+            ++frozen.offsets[(h & (capacity - 1)) + 1];
+        });
+        for (size_t i = 0; i < capacity; ++i) frozen.offsets[i + 1] += frozen.offsets[i];
+        std::vector<size_t> filled(frozen.offsets.begin(), frozen.offsets.end() - 1);
+        frozen.entries.resize(n);
+        for (Entry &e : unsorted)
+        {
+            frozen.entries[filled[e.hash & (capacity - 1)]++] = std::move(e);
+        }
+        return frozen;
+    }
+
+    /// Same semantics as HashMap::get()
+    [[nodiscard]] std::optional<V> get(const K &key) const
+    {
+        if (entries.empty()) return std::nullopt;
+        const size_t h = hasher(key);
+        const size_t index = h & (offsets.size() - 2);
+        const Entry *end = entries.data() + offsets[index + 1];
+        for (const Entry *e = entries.data() + offsets[index]; e != end; ++e)
+        {
+            if (e->hash == h && e->key == key) return std::optional<V>(e->value);
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return entries.size();
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return entries.empty();
+    }
+
+    /// Calls fn(key, value) for every element, in bucket order
+    template <typename F>
+    void forEach(F &&fn) const
+    {
+        for (const Entry &e : entries)
+        {
+            fn(e.key, e.value);
+        }
+    }
+};
+
+#endif //CPPHASHMAP_CONTIGUOUSHASHMAP_H
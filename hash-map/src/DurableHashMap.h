@@ -0,0 +1,396 @@
+#ifndef CPPHASHMAP_DURABLEHASHMAP_H
+#define CPPHASHMAP_DURABLEHASHMAP_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "HashMap.h"
+#include "Serialization.h"
+
+/**
+ * @file DurableHashMap.h
+ * @brief HashMap with a write-ahead log and crash recovery.
+ *
+ * A durable map lives in a directory with two files:
+ *  - "snapshot" — a HashMap::save() snapshot;
+ *  - "wal"      — every put/remove applied after that snapshot.
+ *
+ * Log record layout:
+ *
+ *     uint32 payload length | uint32 checksum | payload
+ *     payload = uint8 op | key | value (put only)
+ *
+ * open() loads the snapshot and replays the log. Replay stops at the first
+ * truncated or corrupt record (a write torn by a crash) and the log is cut
+ * back to the last complete record.
+ *
+ * compact() writes a fresh snapshot and empties the log. Replaying a log
+ * on top of a snapshot that already contains its effects is harmless, so a
+ * crash between the two steps loses nothing.
+ */
+
+enum class Durability
+{
+    /// Records are written to the OS in batches, never fsync'ed
+    None,
+
+    /// Group commit: fsync once per batch_size records or on sync()
+    Batched,
+
+    /// Every put/remove is written and fsync'ed before returning
+    Always
+};
+
+struct DurableOptions
+{
+    /// When writes are made durable
+    Durability durability = Durability::Batched;
+
+    /// Records per group commit (Batched) or per write() call (None)
+    size_t batch_size = 64;
+
+    /// Log size that triggers compact() after a commit, 0 disables it
+    uint64_t compact_log_bytes = 64ull << 20;
+};
+
+template <typename K, typename V>
+class DurableHashMap
+{
+    enum class LogOp : uint8_t
+    {
+        Put = 0,
+        Remove = 1
+    };
+
+    /// In-memory state
+    HashMap<K, V> map;
+
+    /// Directory holding snapshot and wal
+    std::string dir;
+
+    DurableOptions options;
+
+    /// Log file descriptor, -1 when closed
+    int log_fd = -1;
+
+    /// Encoded records not yet written to the log
+    ByteBuffer pending;
+
+    /// Number of records in pending
+    size_t pending_records = 0;
+
+    /// Current log size in bytes, including pending records
+    uint64_t log_bytes = 0;
+
+    /// Sticky I/O error flag
+    bool good = false;
+
+    [[nodiscard]] std::string snapshotPath() const
+    {
+        return dir + "/snapshot";
+    }
+
+    [[nodiscard]] std::string logPath() const
+    {
+        return dir + "/wal";
+    }
+
+    /// FNV-1a over the payload
+    static uint32_t checksum(const char *data, const size_t n)
+    {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < n; ++i)
+        {
+            h ^= static_cast<unsigned char>(data[i]);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    static bool writeAll(const int fd, const char *data, size_t n)
+    {
+        while (n != 0)
+        {
+            const ssize_t written = ::write(fd, data, n);
+            if (written < 0) return false;
+            data += written;
+            n -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    static bool syncPath(const std::string &path, const int flags)
+    {
+        const int fd = ::open(path.c_str(), flags);
+        if (fd < 0) return false;
+        const bool synced = ::fsync(fd) == 0;
+        ::close(fd);
+        return synced;
+    }
+
+    /// Appends one framed record to pending
+    void append(const LogOp op, const K &key, const V *value)
+    {
+        if (!good) return;
+        const size_t start = pending.size();
+        const uint32_t placeholder = 0;
+        pending.writePod(placeholder);
+        pending.writePod(placeholder);
+        pending.writePod(op);
+        Codec<K>::write(pending, key);
+        if (value) Codec<V>::write(pending, *value);
+
+        const size_t header = 2 * sizeof(uint32_t);
+        const auto length = static_cast<uint32_t>(pending.size() - start - header);
+        const uint32_t sum = checksum(pending.data() + start + header, length);
+        pending.patch(start, &length, sizeof(length));
+        pending.patch(start + sizeof(length), &sum, sizeof(sum));
+        log_bytes += pending.size() - start;
+        ++pending_records;
+    }
+
+    /**
+     * @brief Commits pending records as the durability level requires.
+     *
+     * Called after the record has been applied to the map, so that a
+     * compaction triggered here includes it in the snapshot.
+     */
+    void commitIfDue()
+    {
+        if (options.durability == Durability::Always || pending_records >= options.batch_size)
+        {
+            commit(options.durability != Durability::None);
+        }
+    }
+
+    /// Writes pending records to the log, optionally fsync'ing it
+    void commit(const bool durable)
+    {
+        if (!good) return;
+        if (pending.size() != 0 && !writeAll(log_fd, pending.data(), pending.size())) good = false;
+        if (good && durable && ::fdatasync(log_fd) != 0) good = false;
+        pending.clear();
+        pending_records = 0;
+        if (good && options.compact_log_bytes != 0 && log_bytes >= options.compact_log_bytes)
+        {
+            compact();
+        }
+    }
+
+    /**
+     * @brief Applies all complete records of the log to the map.
+     *
+     * @return size of the valid log prefix in bytes
+     */
+    uint64_t replayLog(const std::vector<char> &log)
+    {
+        uint64_t pos = 0;
+        const size_t header = 2 * sizeof(uint32_t);
+        while (log.size() - pos >= header)
+        {
+            uint32_t length;
+            uint32_t sum;
+            std::memcpy(&length, log.data() + pos, sizeof(length));
+            std::memcpy(&sum, log.data() + pos + sizeof(length), sizeof(sum));
+            if (log.size() - pos - header < length) break;
+            const char *payload = log.data() + pos + header;
+            if (checksum(payload, length) != sum) break;
+
+            ByteSpanReader in(payload, length);
+            LogOp op;
+            K key{};
+            V value{};
+            if (!in.readPod(op) || !Codec<K>::read(in, key)) break;
+            if (op == LogOp::Put)
+            {
+                if (!Codec<V>::read(in, value)) break;
+                map.put(key, value);
+            }
+            else if (op == LogOp::Remove)
+            {
+                map.remove(key);
+            }
+            else
+            {
+                break;
+            }
+            pos += header + length;
+        }
+        return pos;
+    }
+
+    static bool readFile(const std::string &path, std::vector<char> &out)
+    {
+        out.clear();
+        std::FILE *f = std::fopen(path.c_str(), "rb");
+        if (!f) return true;
+        char chunk[1 << 16];
+        size_t n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), f)) != 0)
+        {
+            out.insert(out.end(), chunk, chunk + n);
+        }
+        const bool read_ok = !std::ferror(f);
+        std::fclose(f);
+        return read_ok;
+    }
+
+public:
+    DurableHashMap() = default;
+
+    DurableHashMap(const DurableHashMap&) = delete;
+    DurableHashMap& operator=(const DurableHashMap&) = delete;
+
+    ~DurableHashMap()
+    {
+        close();
+    }
+
+    /**
+     * @brief Opens or creates a durable map in directory @p path.
+     *
+     * Recovers the state from the snapshot plus the log tail. The directory
+     * must exist.
+     *
+     * @return true on success; false if the snapshot is unreadable or the
+     *         log cannot be opened
+     */
+    bool open(const std::string &path, const DurableOptions &opts = {})
+    {
+        close();
+        dir = path;
+        options = opts;
+        if (options.batch_size == 0) options.batch_size = 1;
+
+        struct stat st{};
+        if (::stat(snapshotPath().c_str(), &st) == 0 && !map.load(snapshotPath())) return false;
+
+        std::vector<char> log;
+        if (!readFile(logPath(), log)) return false;
+        log_bytes = replayLog(log);
+
+        log_fd = ::open(logPath().c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (log_fd < 0) return false;
+        if (log_bytes != log.size() && (::ftruncate(log_fd, static_cast<off_t>(log_bytes)) != 0
+                                        || ::fsync(log_fd) != 0))
+        {
+            ::close(log_fd);
+            log_fd = -1;
+            return false;
+        }
+        good = true;
+        return true;
+    }
+
+    /// Commits pending records (with fsync unless Durability::None) and closes
+    void close()
+    {
+        if (log_fd >= 0)
+        {
+            commit(options.durability != Durability::None);
+            ::close(log_fd);
+            log_fd = -1;
+        }
+        good = false;
+        pending.clear();
+        pending_records = 0;
+        log_bytes = 0;
+        map.reset();
+    }
+
+    /// Same as HashMap::get(), never touches the disk
+    [[nodiscard]] std::optional<V> get(const K &key) const
+    {
+        return map.get(key);
+    }
+
+    /**
+     * @brief Logs and applies a put.
+     *
+     * With Durability::Always the record is on disk when this returns.
+     * Check ok() for I/O errors.
+     */
+    void put(const K &key, const V &value)
+    {
+        append(LogOp::Put, key, &value);
+        map.put(key, value);
+        commitIfDue();
+    }
+
+    /// Logs and applies a remove of an existing key; check ok() for I/O errors
+    bool remove(const K &key)
+    {
+        if (!map.get(key)) return false;
+        append(LogOp::Remove, key, nullptr);
+        map.remove(key);
+        commitIfDue();
+        return true;
+    }
+
+    /// Writes and fsyncs all pending records (group commit)
+    bool sync()
+    {
+        commit(true);
+        return good;
+    }
+
+    /**
+     * @brief Writes a fresh snapshot and empties the log.
+     *
+     * The snapshot goes to a temporary file that is fsync'ed and renamed
+     * over the old one before the log is truncated.
+     *
+     * @note Complexity is O(n + capacity).
+     */
+    bool compact()
+    {
+        if (!good) return false;
+        if (pending.size() != 0 && !writeAll(log_fd, pending.data(), pending.size())) good = false;
+        pending.clear();
+        pending_records = 0;
+
+        const std::string tmp = snapshotPath() + ".tmp";
+        if (!good || !map.save(tmp) || !syncPath(tmp, O_RDONLY)
+            || std::rename(tmp.c_str(), snapshotPath().c_str()) != 0
+            || !syncPath(dir, O_RDONLY | O_DIRECTORY)
+            || ::ftruncate(log_fd, 0) != 0 || ::fsync(log_fd) != 0)
+        {
+            good = false;
+            return false;
+        }
+        log_bytes = 0;
+        return true;
+    }
+
+    /// False after any I/O error or while closed
+    [[nodiscard]] bool ok() const
+    {
+        return good;
+    }
+
+    /// Returns the log size in bytes, including records not yet written
+    [[nodiscard]] uint64_t logSize() const
+    {
+        return log_bytes;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return map.size();
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return map.empty();
+    }
+};
+
+#endif //CPPHASHMAP_DURABLEHASHMAP_H
@@ -0,0 +1,206 @@
+#ifndef CPPHASHMAP_FILTEREDHASHMAP_H
+#define CPPHASHMAP_FILTEREDHASHMAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional> // std::hash
+#include <optional>
+#include <vector>
+
+#include "HashMap.h"
+
+/**
+ * @file FilteredHashMap.h
+ * @brief HashMap with a blocked Bloom filter in front of the bucket table.
+ *
+ * For workloads where most get() calls miss. Every key is also added to a
+ * split-block Bloom filter: a 32-byte block picked by the hash, with one
+ * bit set in each of its eight 32-bit words. get() checks that block first
+ * and touches the bucket table only if all eight bits are set, so a miss
+ * costs one cache line instead of a bucket pointer and a chain walk.
+ *
+ * The filter has 16 bits per bucket, about 21 bits per key at the resize
+ * threshold and 42 right after a resize: well under 1% false positives.
+ *
+ * A Bloom filter cannot delete. remove() leaves the key's bits set, which
+ * only raises the false-positive rate; the filter is rebuilt from the
+ * table's cached hashes whenever the table grows, and by rebuildFilter(),
+ * meant to be called periodically by delete-heavy users.
+ */
+
+template <typename K, typename V>
+class FilteredHashMap
+{
+    using Internals = HashMapInternals<K, V, 0>;
+
+    /// One filter block, half a cache line
+    struct alignas(32) Block
+    {
+        uint32_t words[8];
+    };
+
+    /// Filter bits per bucket of the table
+    static constexpr size_t BITS_PER_BUCKET = 16;
+
+    HashMap<K, V> map;
+
+    /// Filter blocks, a power of two, empty until the first put()
+    std::vector<Block> filter;
+
+    /// Table capacity the filter was sized for
+    size_t filter_capacity = 0;
+
+    /// Keys removed since the last rebuild, still present in the filter
+    size_t stale = 0;
+
+    std::hash<K> hasher;
+
+    /// splitmix64 finalizer; std::hash of integers is the identity
+    static uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        x ^= x >> 31;
+        return x;
+    }
+
+    /// Bit of each of the 8 block words, from the low 32 bits of the mixed hash
+    static uint32_t bitOf(const uint32_t x, const unsigned word)
+    {
+        static constexpr uint32_t SALT[8] = {
+            0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+            0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+        };
+        return uint32_t{1} << ((x * SALT[word]) >> 27);
+    }
+
+    void insert(const size_t h)
+    {
+        const uint64_t m = mix(h);
+        Block &b = filter[(m >> 32) & (filter.size() - 1)];
+        for (unsigned i = 0; i < 8; ++i) b.words[i] |= bitOf(static_cast<uint32_t>(m), i);
+    }
+
+    [[nodiscard]] bool mayContain(const size_t h) const
+    {
+        const uint64_t m = mix(h);
+        const Block &b = filter[(m >> 32) & (filter.size() - 1)];
+        bool all = true;
+        for (unsigned i = 0; i < 8; ++i) all &= (b.words[i] & bitOf(static_cast<uint32_t>(m), i)) != 0;
+        return all;
+    }
+
+public:
+    FilteredHashMap() = default;
+
+    FilteredHashMap(const FilteredHashMap&) = delete;
+    FilteredHashMap& operator=(const FilteredHashMap&) = delete;
+
+    FilteredHashMap(FilteredHashMap&&) noexcept = default;
+    FilteredHashMap& operator=(FilteredHashMap&&) noexcept = default;
+
+    /// Same semantics as HashMap::get(); most misses are answered by the filter
+    [[nodiscard]] std::optional<V> get(const K &key) const
+    {
+        if (filter.empty()) return std::nullopt;
+        const size_t h = hasher(key);
+        if (!mayContain(h)) return std::nullopt;
+        // Walk the chain with the hash already computed
+        const Node<K, V> *const *buckets = Internals::buckets(map);
+        for (const Node<K, V> *e = buckets[h & (Internals::capacity(map) - 1)]; e; e = e->next)
+        {
+            if (e->hash == h && e->key == key) return std::optional<V>(e->value);
+        }
+        return std::nullopt;
+    }
+
+    /// Same semantics as HashMap::put(); rebuilds the filter when the table grows
+    void put(const K &key, const V &value)
+    {
+        map.put(key, value);
+        if (filter.empty() || Internals::capacity(map) != filter_capacity)
+        {
+            rebuildFilter();
+            return;
+        }
+        insert(hasher(key));
+    }
+
+    /// Same semantics as HashMap::remove(); the key stays in the filter
+    bool remove(const K &key)
+    {
+        if (!map.remove(key)) return false;
+        ++stale;
+        return true;
+    }
+
+    /**
+     * @brief Rebuilds the filter from the keys currently in the table.
+     *
+     * Drops the bits of removed keys. Uses the cached hashes, no key is
+     * rehashed.
+     *
+     * @note Complexity is O(n + capacity).
+     */
+    void rebuildFilter()
+    {
+        const Node<K, V> *const *buckets = Internals::buckets(map);
+        if (!buckets)
+        {
+            std::vector<Block>().swap(filter);
+            filter_capacity = 0;
+            stale = 0;
+            return;
+        }
+        filter_capacity = Internals::capacity(map);
+        const size_t blocks = std::max<size_t>(1, filter_capacity * BITS_PER_BUCKET / (8 * sizeof(Block)));
+        filter.assign(blocks, Block{});
+        for (size_t i = 0; i < filter_capacity; ++i)
+        {
+            for (const Node<K, V> *e = buckets[i]; e; e = e->next) insert(e->hash);
+        }
+        stale = 0;
+    }
+
+    /// Removed keys still set in the filter, a hint for calling rebuildFilter()
+    [[nodiscard]] size_t staleKeys() const
+    {
+        return stale;
+    }
+
+    /// Removes all elements, keeps the table and the (now empty) filter
+    void clear()
+    {
+        map.clear();
+        std::fill(filter.begin(), filter.end(), Block{});
+        stale = 0;
+    }
+
+    /// Removes all elements and frees the table and the filter
+    void reset()
+    {
+        map.reset();
+        rebuildFilter();
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return map.size();
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return map.empty();
+    }
+
+    /// Calls fn(key, value) for every element, in unspecified order
+    template <typename F>
+    void forEach(F &&fn) const
+    {
+        map.forEach(fn);
+    }
+};
+
+#endif //CPPHASHMAP_FILTEREDHASHMAP_H
@@ -0,0 +1,221 @@
+#ifndef CPPHASHMAP_FROZENHASHMAP_H
+#define CPPHASHMAP_FROZENHASHMAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional> // std::hash
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "HashMap.h"
+
+/**
+ * @file FrozenHashMap.h
+ * @brief Immutable map indexed by a minimal perfect hash function.
+ *
+ * FrozenHashMap::freeze() copies a populated HashMap into two dense arrays
+ * of exactly size() entries, keys and values, plus one 32-bit seed per
+ * group of four keys:
+ *
+ *     group = reduce(mix(hash), groups)
+ *     slot  = reduce(mix(hash ^ seed[group]), size)
+ *
+ * where reduce(x, n) = x * n / 2^64 maps a 64-bit value to [0, n).
+ *
+ * The seeds are chosen at build time (CHD-style hash and displace, largest
+ * groups first) so that every key gets its own slot. A lookup is one
+ * std::hash call, one seed load, one array access and one key compare;
+ * keys that are not in the map fail that compare.
+ *
+ * Keys must have distinct std::hash values, as for any perfect hash: true
+ * for integers, and a 64-bit collision between strings is negligible.
+ * freeze() checks this up front and returns std::nullopt for keys that no
+ * seed can separate, instead of searching forever.
+ *
+ * Index overhead is 8 bits per key, compared with a node, a cached hash, a
+ * next pointer and a bucket pointer per entry in HashMap. Building takes
+ * O(n log n) expected time, dominated by placing the last single-key groups.
+ */
+
+template <typename K, typename V>
+class FrozenHashMap
+{
+    /// Average number of keys per seed group
+    static constexpr size_t GROUP_SIZE = 4;
+
+    /// Seeds tried per group at least; the last groups need about n tries
+    static constexpr uint64_t MIN_SEEDS = uint64_t{1} << 20;
+
+    std::vector<uint32_t> seeds;
+    std::vector<K> keys;
+    std::vector<V> values;
+
+    std::hash<K> hasher;
+
+    /// splitmix64 finalizer
+    static uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        x ^= x >> 31;
+        return x;
+    }
+
+    /// Maps @p x to [0, n) with a multiply instead of a division
+    static size_t reduce(const uint64_t x, const size_t n)
+    {
+        return static_cast<size_t>((static_cast<unsigned __int128>(x) * n) >> 64);
+    }
+
+    [[nodiscard]] size_t groupOf(const uint64_t h) const
+    {
+        return reduce(mix(h), seeds.size());
+    }
+
+    [[nodiscard]] size_t slotOf(const uint64_t h, const uint32_t seed) const
+    {
+        return reduce(mix(h ^ (static_cast<uint64_t>(seed) + 1) * 0x9e3779b97f4a7c15ull), keys.size());
+    }
+
+public:
+    FrozenHashMap() = default;
+
+    FrozenHashMap(FrozenHashMap&&) noexcept = default;
+    FrozenHashMap& operator=(FrozenHashMap&&) noexcept = default;
+
+    FrozenHashMap(const FrozenHashMap&) = delete;
+    FrozenHashMap& operator=(const FrozenHashMap&) = delete;
+
+    /**
+     * @brief Builds an immutable copy of @p map.
+     *
+     * Requires default constructible K and V.
+     *
+     * @return the copy, or std::nullopt if two keys have equal std::hash
+     *         values (or, with vanishing probability, no seed is found)
+     *
+     * @note Complexity is O(n log n) expected, the source is left unchanged.
+     */
+    template <size_t N>
+    static std::optional<FrozenHashMap> freeze(const HashMap<K, V, N> &map)
+    {
+        FrozenHashMap frozen;
+        const size_t n = map.size();
+        if (n == 0) return frozen;
+
+        std::vector<uint64_t> hashes;
+        std::vector<const K *> src_keys;
+        std::vector<const V *> src_values;
+        hashes.reserve(n);
+        src_keys.reserve(n);
+        src_values.reserve(n);
+        map.forEach([&](const K &key, const V &value)
+        {
+            hashes.push_back(frozen.hasher(key));
+            src_keys.push_back(&key);
+            src_values.push_back(&value);
+        });
+
+        // Keys with equal full hashes collide for every seed
+        std::vector<uint64_t> sorted(hashes);
+        std::sort(sorted.begin(), sorted.end());
+        if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) return std::nullopt;
+        std::vector<uint64_t>().swap(sorted);
+        const uint64_t max_seeds = std::min<uint64_t>(UINT32_MAX, std::max<uint64_t>(MIN_SEEDS, 64 * uint64_t{n}));
+
+        frozen.seeds.assign((n + GROUP_SIZE - 1) / GROUP_SIZE, 0);
+        frozen.keys.resize(n);
+        frozen.values.resize(n);
+        const size_t groups = frozen.seeds.size();
+
+        // Entry indices grouped by seed group (counting sort)
+        std::vector<size_t> start(groups + 1, 0);
+        for (size_t i = 0; i < n; ++i) ++start[frozen.groupOf(hashes[i]) + 1];
+        size_t largest = 0;
+        for (size_t g = 0; g < groups; ++g)
+        {
+            largest = std::max(largest, start[g + 1]);
+            start[g + 1] += start[g];
+        }
+        std::vector<size_t> members(n);
+        std::vector<size_t> filled(start.begin(), start.end() - 1);
+        for (size_t i = 0; i < n; ++i)
+        {
+            members[filled[frozen.groupOf(hashes[i])]++] = i;
+        }
+
+        // Groups by descending size: big groups are placed while slots are free
+        std::vector<std::vector<size_t>> by_size(largest + 1);
+        for (size_t g = 0; g < groups; ++g)
+        {
+            by_size[start[g + 1] - start[g]].push_back(g);
+        }
+
+        std::vector<char> taken(n, 0);
+        std::vector<size_t> slots(largest);
+        for (size_t sz = largest; sz > 0; --sz)
+        {
+            for (const size_t g : by_size[sz])
+            {
+                uint64_t seed = 0;
+                for (;; ++seed)
+                {
+                    if (seed == max_seeds) return std::nullopt;
+                    bool fits = true;
+                    for (size_t k = 0; k < sz && fits; ++k)
+                    {
+                        const size_t s = frozen.slotOf(hashes[members[start[g] + k]], static_cast<uint32_t>(seed));
+                        fits = !taken[s];
+                        for (size_t j = 0; j < k && fits; ++j) fits = slots[j] != s;
+                        slots[k] = s;
+                    }
+                    if (fits) break;
+                }
+                frozen.seeds[g] = static_cast<uint32_t>(seed);
+                for (size_t k = 0; k < sz; ++k)
+                {
+                    const size_t i = members[start[g] + k];
+                    taken[slots[k]] = 1;
+                    frozen.keys[slots[k]] = *src_keys[i];
+                    frozen.values[slots[k]] = *src_values[i];
+                }
+            }
+        }
+        return frozen;
+    }
+
+    /// Same semantics as HashMap::get()
+    [[nodiscard]] std::optional<V> get(const K &key) const
+    {
+        if (keys.empty()) return std::nullopt;
+        const uint64_t h = hasher(key);
+        const size_t s = slotOf(h, seeds[groupOf(h)]);
+        if (!(keys[s] == key)) return std::nullopt;
+        return std::optional<V>(values[s]);
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return keys.size();
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return keys.empty();
+    }
+
+    /// Calls fn(key, value) for every element, in unspecified order
+    template <typename F>
+    void forEach(F &&fn) const
+    {
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            fn(keys[i], values[i]);
+        }
+    }
+};
+
+#endif //CPPHASHMAP_FROZENHASHMAP_H
@@ -0,0 +1,340 @@
+#ifndef CPPHASHMAP_GROUPHASHMAP_H
+#define CPPHASHMAP_GROUPHASHMAP_H
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional> // std::hash
+#include <optional>
+#include <utility>
+
+/**
+ * @file GroupHashMap.h
+ * @brief Chained hash map with cache-line-sized bucket groups.
+ *
+ * Every bucket is one 64-byte group holding up to 7 node pointers and a
+ * 1-byte fingerprint per pointer:
+ *
+ *     | tag0 .. tag6 | count | node0 | node1 | ... | node6 |
+ *       7 bytes        1 byte  7 x 8 bytes
+ *
+ * A node stays at the address put() allocated it at until it is removed,
+ * as in HashMap, so find() pointers survive growth. Only when a group is
+ * full do further nodes go to an overflow chain of that group.
+ *
+ * get() compares all 7 tags against the key's fingerprint at once (SWAR
+ * on the 8-byte tag word) and loads only the nodes whose tag matches,
+ * usually just the one holding the key, so a lookup reads one cache line
+ * of the table and at most one node. A miss reads no node at all in ~95%
+ * of cases (7 tags of 7 bits each).
+ *
+ * The table doubles when the average group holds more than 4 entries.
+ */
+
+template <typename K, typename V>
+class GroupHashMap
+{
+    static_assert(std::endian::native == std::endian::little, "tag lanes assume little-endian byte order");
+
+    struct GroupNode
+    {
+        const K key;
+        V value;
+        const size_t hash;
+
+        /// Next node of the overflow chain, unused while the node sits in a group
+        GroupNode *next;
+    };
+
+    static constexpr unsigned SLOTS = 7;
+
+    /// Average entries per group before the table doubles
+    static constexpr size_t MAX_LOAD = 4;
+
+    static constexpr uint64_t LOW_BITS = 0x0101010101010101ull;
+
+    /// High bit of each tag lane, the count byte excluded
+    static constexpr uint64_t TAG_LANES = 0x0080808080808080ull;
+
+    /// Set in Group::count while the group's overflow chain is non-empty
+    static constexpr uint8_t OVERFLOWED = 0x80;
+    static constexpr uint8_t COUNT_MASK = 0x0f;
+
+    struct alignas(64) Group
+    {
+        /// Fingerprints of the used slots (high bit set), 0 for free slots
+        uint8_t tags[SLOTS];
+
+        /// Used slots (always the first ones), plus OVERFLOWED
+        uint8_t count;
+
+        GroupNode *slots[SLOTS];
+    };
+
+    static_assert(sizeof(Group) == 64);
+
+    /// Groups, nullptr until the first put()
+    Group *groups = nullptr;
+
+    /// Overflow chain heads per group, nullptr until a group first overflows
+    GroupNode **overflow = nullptr;
+
+    size_t sz = 0;
+    size_t capacity = 4;
+
+    std::hash<K> hasher;
+
+    /// Fingerprint byte of a hash, always non-zero
+    static uint8_t tagOf(const size_t h)
+    {
+        return static_cast<uint8_t>(0x80 | ((static_cast<uint64_t>(h) * 0x9e3779b97f4a7c15ull) >> 57));
+    }
+
+    /// One high bit per used lane of @p g whose tag equals @p tag
+    static uint64_t match(const Group &g, const uint8_t tag)
+    {
+        uint64_t word;
+        std::memcpy(&word, g.tags, sizeof(word));
+        const uint64_t x = word ^ (LOW_BITS * tag);
+        const uint64_t used = (uint64_t{1} << (8 * (g.count & COUNT_MASK))) - 1;
+        // Exact for the lowest equal lane; false positives above it are filtered by the key compare
+        return (x - LOW_BITS) & ~x & TAG_LANES & used;
+    }
+
+    [[nodiscard]] GroupNode *find(const K &key, const size_t h) const
+    {
+        const size_t index = h & (capacity - 1);
+        const Group &g = groups[index];
+        for (uint64_t m = match(g, tagOf(h)); m; m &= m - 1)
+        {
+            GroupNode *e = g.slots[std::countr_zero(m) >> 3];
+            if (e->hash == h && e->key == key) return e;
+        }
+        if (g.count & OVERFLOWED)
+        {
+            for (GroupNode *e = overflow[index]; e; e = e->next)
+            {
+                if (e->hash == h && e->key == key) return e;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Adds @p e to its group, or to the group's overflow chain when full
+    void place(GroupNode *e)
+    {
+        const size_t index = e->hash & (capacity - 1);
+        Group &g = groups[index];
+        if (g.count < SLOTS)
+        {
+            g.tags[g.count] = tagOf(e->hash);
+            g.slots[g.count] = e;
+            ++g.count;
+            return;
+        }
+        if (!overflow) overflow = new GroupNode*[capacity]();
+        e->next = overflow[index];
+        overflow[index] = e;
+        g.count |= OVERFLOWED;
+    }
+
+    /// Calls fn(node) for every node; fn may delete the node
+    template <typename F>
+    void forEachNode(F &&fn) const
+    {
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            const Group &g = groups[i];
+            for (unsigned s = 0; s < (g.count & COUNT_MASK); ++s) fn(g.slots[s]);
+            if (!(g.count & OVERFLOWED)) continue;
+            GroupNode *e = overflow[i];
+            while (e)
+            {
+                GroupNode *next = e->next;
+                fn(e);
+                e = next;
+            }
+        }
+    }
+
+    /// Doubles the table; nodes are relinked, never moved
+    void resize()
+    {
+        Group *old_groups = std::exchange(groups, new Group[capacity * 2]());
+        GroupNode **old_overflow = std::exchange(overflow, nullptr);
+        const size_t old_cap = std::exchange(capacity, capacity * 2);
+        for (size_t i = 0; i < old_cap; ++i)
+        {
+            const Group &g = old_groups[i];
+            for (unsigned s = 0; s < (g.count & COUNT_MASK); ++s) place(g.slots[s]);
+            if (!(g.count & OVERFLOWED)) continue;
+            GroupNode *e = old_overflow[i];
+            while (e)
+            {
+                GroupNode *next = e->next;
+                place(e);
+                e = next;
+            }
+        }
+        delete[] old_groups;
+        delete[] old_overflow;
+    }
+
+public:
+    GroupHashMap() = default;
+
+    GroupHashMap(const GroupHashMap&) = delete;
+    GroupHashMap& operator=(const GroupHashMap&) = delete;
+
+    GroupHashMap(GroupHashMap &&other) noexcept
+        : groups(std::exchange(other.groups, nullptr)),
+          overflow(std::exchange(other.overflow, nullptr)),
+          sz(std::exchange(other.sz, 0)),
+          capacity(std::exchange(other.capacity, 4)) {}
+
+    GroupHashMap& operator=(GroupHashMap &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            groups = std::exchange(other.groups, nullptr);
+            overflow = std::exchange(other.overflow, nullptr);
+            sz = std::exchange(other.sz, 0);
+            capacity = std::exchange(other.capacity, 4);
+        }
+        return *this;
+    }
+
+    ~GroupHashMap()
+    {
+        reset();
+    }
+
+    /// Same semantics as HashMap::get()
+    [[nodiscard]] std::optional<V> get(const K &key) const
+    {
+        if (sz == 0) return std::nullopt;
+        const GroupNode *e = find(key, hasher(key));
+        if (!e) return std::nullopt;
+        return std::optional<V>(e->value);
+    }
+
+    /**
+     * @brief Returns a pointer to the value of @p key, or nullptr.
+     *
+     * The pointer stays valid across put() and growth until the key is
+     * removed or the map is cleared.
+     */
+    [[nodiscard]] V *find(const K &key)
+    {
+        if (sz == 0) return nullptr;
+        GroupNode *e = find(key, hasher(key));
+        return e ? &e->value : nullptr;
+    }
+
+    /// Same semantics as HashMap::put()
+    void put(const K &key, const V &value)
+    {
+        const size_t h = hasher(key);
+        if (!groups) groups = new Group[capacity]();
+        if (GroupNode *e = find(key, h))
+        {
+            e->value = value;
+            return;
+        }
+        place(new GroupNode{key, value, h, nullptr});
+        if (++sz > capacity * MAX_LOAD)
+        {
+            resize();
+        }
+    }
+
+    /// Removes an element by key
+    bool remove(const K &key)
+    {
+        if (sz == 0) return false;
+        const size_t h = hasher(key);
+        const size_t index = h & (capacity - 1);
+        Group &g = groups[index];
+        for (uint64_t m = match(g, tagOf(h)); m; m &= m - 1)
+        {
+            const unsigned s = std::countr_zero(m) >> 3;
+            GroupNode *e = g.slots[s];
+            if (e->hash != h || !(e->key == key)) continue;
+            delete e;
+            --sz;
+            // Keep slots packed, or refill the slot from the overflow chain
+            if (g.count & OVERFLOWED)
+            {
+                GroupNode *moved = overflow[index];
+                overflow[index] = moved->next;
+                if (!moved->next) g.count &= COUNT_MASK;
+                g.tags[s] = tagOf(moved->hash);
+                g.slots[s] = moved;
+                return true;
+            }
+            const unsigned last = --g.count;
+            g.tags[s] = g.tags[last];
+            g.slots[s] = g.slots[last];
+            g.tags[last] = 0;
+            return true;
+        }
+        if (!(g.count & OVERFLOWED)) return false;
+        for (GroupNode **link = &overflow[index]; *link; link = &(*link)->next)
+        {
+            GroupNode *e = *link;
+            if (e->hash == h && e->key == key)
+            {
+                *link = e->next;
+                if (!overflow[index]) g.count &= COUNT_MASK;
+                delete e;
+                --sz;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Removes all elements, keeps the group array
+    void clear()
+    {
+        if (!groups || sz == 0) return;
+        forEachNode([](GroupNode *e) { delete e; });
+        for (size_t i = 0; i < capacity; ++i) groups[i] = Group{};
+        delete[] overflow;
+        overflow = nullptr;
+        sz = 0;
+    }
+
+    /// Removes all elements and frees the group and overflow arrays
+    void reset()
+    {
+        clear();
+        delete[] groups;
+        groups = nullptr;
+        // An emptied map may still hold the overflow array, clear() skips it
+        delete[] overflow;
+        overflow = nullptr;
+        capacity = 4;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return sz;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return sz == 0;
+    }
+
+    /// Calls fn(key, value) for every element, in unspecified order
+    template <typename F>
+    void forEach(F &&fn) const
+    {
+        if (!groups) return;
+        forEachNode([&](const GroupNode *e) { fn(e->key, e->value); });
+    }
+};
+
+#endif //CPPHASHMAP_GROUPHASHMAP_H
@@ -1,8 +1,15 @@
 #ifndef CPPHASHMAP_HASHMAP_H
 #define CPPHASHMAP_HASHMAP_H
 
+#include <bit>
+#include <cstdint>
 #include <functional> // std::hash
+#include <new>
 #include <optional>
+#include <string>
+#include <utility>
+
+#include "Serialization.h"
 
 /**
  * @file HashMap.h
@@ -16,6 +23,15 @@
  *     index = hash & (capacity - 1)
  *
  * This scheme works correctly only if capacity is a power of two.
+ *
+ * The bucket array is allocated lazily by the first put(): a default
+ * constructed, reset or moved-from map holds no heap memory at all.
+ *
+ * Small-map mode: with the template parameter N > 0 the first N entries are
+ * stored inline in the HashMap object itself and searched linearly. No
+ * bucket array and no nodes are allocated until the (N + 1)-th key is
+ * inserted, then all entries move to the bucket table, which is kept until
+ * reset(). With N = 0 (default) the map always uses the bucket table.
  */
 
 template<typename K, typename V>
@@ -35,14 +51,74 @@ struct Node
 
     Node(const K &k, const V &v, const size_t h, Node *n = nullptr)
         : key(k), value(v), hash(h), next(n) {}
+
+    Node(K &&k, V &&v, const size_t h, Node *n = nullptr)
+        : key(std::move(k)), value(std::move(v)), hash(h), next(n) {}
+};
+
+/// Inline key-value pair of a small map
+template<typename K, typename V>
+struct InlineEntry
+{
+    K key;
+    V value;
+};
+
+/// Raw storage for N inline entries
+template<typename K, typename V, size_t N>
+struct InlineStorage
+{
+    alignas(InlineEntry<K, V>) unsigned char data[N * sizeof(InlineEntry<K, V>)];
+
+    InlineEntry<K, V> *entries()
+    {
+        return std::launder(reinterpret_cast<InlineEntry<K, V> *>(data));
+    }
+
+    const InlineEntry<K, V> *entries() const
+    {
+        return std::launder(reinterpret_cast<const InlineEntry<K, V> *>(data));
+    }
 };
 
-template <typename K, typename V>
+template<typename K, typename V>
+struct InlineStorage<K, V, 0> {};
+
+template <typename K, typename V, size_t N>
+struct HashMapInternals;
+
+/// How the bucket table orders the nodes of a chain
+enum class ChainOrder
+{
+    /// New nodes are prepended, chains are never reordered (default)
+    Unordered,
+
+    /// A node found by get() moves to the head of its chain
+    MoveToFront,
+
+    /// A node found by get() swaps places with its predecessor
+    Transpose,
+
+    /// Chains are kept sorted by hash, lookups stop past the target hash
+    SortedByHash
+};
+
+inline constexpr char SNAPSHOT_MAGIC[4] = {'H', 'M', 'S', 'N'};
+inline constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+/// Load factors load() accepts; HashMap itself always uses 0.75
+inline constexpr float SNAPSHOT_MIN_LOAD_FACTOR = 0.25f;
+inline constexpr float SNAPSHOT_MAX_LOAD_FACTOR = 1.0f;
+
+template <typename K, typename V, size_t N = 0>
 class HashMap
 {
-    /// Array of bucket pointers
+    /// Array of bucket pointers, nullptr while a small map is in inline mode
     Node<K, V> **buckets = nullptr;
 
+    /// Inline entries [0, sz) while buckets is nullptr (only if N > 0)
+    [[no_unique_address]] InlineStorage<K, V, N> small;
+
     /// Current number of elements
     size_t sz = 0;
 
@@ -55,9 +131,165 @@ class HashMap
     /// Threshold for resize
     size_t threshold = static_cast<size_t>(capacity * load_factor);
 
+    /// Chain reordering done by get()
+    ChainOrder chain_order = ChainOrder::Unordered;
+
     /// Hash function
     std::hash<K> hasher;
 
+    /// Storage of a destroyed node kept for reuse
+    struct FreeSlot
+    {
+        FreeSlot *next;
+    };
+
+    /// Node storage released by clear(), reused by put()
+    FreeSlot *free_slots = nullptr;
+
+    /**
+     * @brief Creates a node, reusing storage released by clear() if any.
+     *
+     * @note Allocates only when there is no recycled storage left.
+     */
+    template <typename KK, typename VV>
+    Node<K, V> *createNode(KK &&key, VV &&value, const size_t h, Node<K, V> *next)
+    {
+        void *mem;
+        if (free_slots)
+        {
+            mem = free_slots;
+            free_slots = free_slots->next;
+        }
+        else
+        {
+            mem = ::operator new(sizeof(Node<K, V>));
+        }
+        try
+        {
+            return new (mem) Node<K, V>(std::forward<KK>(key), std::forward<VV>(value), h, next);
+        }
+        catch (...)
+        {
+            free_slots = new (mem) FreeSlot{free_slots};
+            throw;
+        }
+    }
+
+    /// Destroys a node and frees its storage
+    static void destroyNode(Node<K, V> *e)
+    {
+        e->~Node();
+        ::operator delete(e);
+    }
+
+    /// Destroys a node and keeps its storage for reuse
+    void recycleNode(Node<K, V> *e)
+    {
+        e->~Node();
+        free_slots = new (e) FreeSlot{free_slots};
+    }
+
+    /// Frees all storage kept by recycleNode()
+    void releaseFreeSlots()
+    {
+        while (free_slots)
+        {
+            FreeSlot *next = free_slots->next;
+            ::operator delete(free_slots);
+            free_slots = next;
+        }
+    }
+
+    /// Returns true while a small map keeps its entries inline
+    [[nodiscard]] bool isInline() const
+    {
+        if constexpr (N > 0) return buckets == nullptr;
+        else return false;
+    }
+
+    /// Destroys all inline entries (inline mode only)
+    void destroyInline()
+    {
+        if constexpr (N > 0)
+        {
+            InlineEntry<K, V> *entries = small.entries();
+            for (size_t i = 0; i < sz; ++i)
+            {
+                entries[i].~InlineEntry();
+            }
+            sz = 0;
+        }
+    }
+
+    /**
+     * @brief Moves inline entries into a freshly allocated bucket table.
+     *
+     * The table is sized so that it can hold N + 1 entries without
+     * resizing, the caller inserts the new key right after.
+     */
+    void spill()
+    {
+        if constexpr (N > 0)
+        {
+            size_t cap = capacity;
+            while (static_cast<size_t>(cap * load_factor) < N + 1)
+            {
+                cap *= 2;
+            }
+            const size_t count = sz;
+            init(cap);
+            InlineEntry<K, V> *entries = small.entries();
+            for (size_t i = 0; i < count; ++i)
+            {
+                const size_t h = hasher(entries[i].key);
+                const size_t index = h & (capacity - 1);
+                buckets[index] = createNode(std::move(entries[i].key), std::move(entries[i].value),
+                                            h, buckets[index]);
+                entries[i].~InlineEntry();
+            }
+            sz = count;
+            sortChains();
+        }
+    }
+
+    /**
+     * @brief Moves the whole state of @p other into this unallocated map.
+     *
+     * @p other is left in the default constructed state.
+     */
+    void takeFrom(HashMap &other) noexcept
+    {
+        chain_order = std::exchange(other.chain_order, ChainOrder::Unordered);
+        load_factor = std::exchange(other.load_factor, 0.75f);
+        if constexpr (N > 0)
+        {
+            if (other.isInline())
+            {
+                InlineEntry<K, V> *from = other.small.entries();
+                for (size_t i = 0; i < other.sz; ++i)
+                {
+                    new (&small.entries()[i]) InlineEntry<K, V>{std::move(from[i])};
+                }
+                sz = other.sz;
+                threshold = static_cast<size_t>(capacity * load_factor);
+                other.destroyInline();
+                other.threshold = static_cast<size_t>(other.capacity * other.load_factor);
+                return;
+            }
+        }
+        buckets = other.buckets;
+        sz = other.sz;
+        capacity = other.capacity;
+        threshold = other.threshold;
+        free_slots = other.free_slots;
+
+        other.buckets = nullptr;
+        other.free_slots = nullptr;
+        other.sz = 0;
+        other.capacity = 16;
+        other.threshold = static_cast<size_t>(other.capacity * other.load_factor);
+    }
+
     /**
      * @brief Initializes the hash map.
      *
@@ -68,7 +300,7 @@ class HashMap
      *            Must be a power of two, otherwise index hashing will not work
      *            correctly.
      *
-     * @note Called in the constructor and when resizing the table.
+     * @note Called by the first put() and when resizing the table.
      */
     void init(const size_t cap = 16)
     {
@@ -87,6 +319,8 @@ class HashMap
      *
      * Creates a new bucket array of twice the size, calls init(cap * 2) and
      * redistributes all elements from the old array into the new one.
+     * Bucket i splits into buckets i and i + old capacity; both keep the
+     * relative order of the old chain.
      *
      * @note Average complexity is O(n), where n is the number of elements.
      *       Called automatically when threshold is exceeded in put().
@@ -101,20 +335,77 @@ class HashMap
 
         for (size_t i = 0; i < old_cap; ++i)
         {
-            Node<K, V> *e = old_buckets[i];
+            // Append to the tails of the two target chains
+            Node<K, V> **tails[2] = {&buckets[i], &buckets[i + old_cap]};
+            for (Node<K, V> *e = old_buckets[i]; e; e = e->next)
+            {
+                Node<K, V> **&tail = tails[(e->hash & old_cap) != 0];
+                *tail = e;
+                tail = &e->next;
+            }
+            *tails[0] = nullptr;
+            *tails[1] = nullptr;
+            old_buckets[i] = nullptr;
+        }
+        delete[] old_buckets;
+    }
+
+    /// Sorts every chain by hash if chain_order is SortedByHash (insertion sort)
+    void sortChains()
+    {
+        if (chain_order != ChainOrder::SortedByHash || !buckets) return;
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            Node<K, V> *sorted = nullptr;
+            Node<K, V> *e = buckets[i];
             while (e)
             {
-                size_t index = e->hash & (capacity - 1);
                 Node<K, V> *next = e->next;
-                e->next = buckets[index];
-                buckets[index] = e;
+                Node<K, V> **link = &sorted;
+                while (*link && (*link)->hash <= e->hash) link = &(*link)->next;
+                e->next = *link;
+                *link = e;
                 e = next;
             }
-            old_buckets[i] = nullptr;
+            buckets[i] = sorted;
         }
-        delete[] old_buckets;
     }
 
+    /**
+     * @brief Chained lookup that reorders the chain on a hit (see ChainOrder).
+     *
+     * Relinks nodes through the bucket array, which get() may do although
+     * it is const: the map's contents do not change, only their order.
+     */
+    [[nodiscard]] const Node<K, V> *findReordering(const K &key, const size_t h) const
+    {
+        Node<K, V> **head = &buckets[h & (capacity - 1)];
+        Node<K, V> **prev_link = nullptr;
+        for (Node<K, V> **link = head; *link; prev_link = link, link = &(*link)->next)
+        {
+            Node<K, V> *e = *link;
+            if (e->hash != h || !(e->key == key)) continue;
+            if (link == head) return e;
+            if (chain_order == ChainOrder::MoveToFront)
+            {
+                *link = e->next;
+                e->next = *head;
+                *head = e;
+            }
+            else
+            {
+                Node<K, V> *prev = *prev_link;
+                prev->next = e->next;
+                e->next = prev;
+                *prev_link = e;
+            }
+            return e;
+        }
+        return nullptr;
+    }
+
+    friend struct HashMapInternals<K, V, N>;
+
 protected:
 
     [[nodiscard]] size_t getCapacity() const
@@ -133,17 +424,33 @@ protected:
     }
 
 public:
-    HashMap()
-    {
-        init();
-    }
+    /// Creates an empty map, allocates nothing
+    HashMap() = default;
 
     HashMap(const HashMap&) = delete;
     HashMap& operator=(const HashMap&) = delete; // TODO
 
+    /// Takes over all elements of @p other, which is left empty and unallocated
+    HashMap(HashMap &&other) noexcept
+    {
+        takeFrom(other);
+    }
+
+    /// Releases own elements and takes over those of @p other
+    HashMap &operator=(HashMap &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            takeFrom(other);
+        }
+        return *this;
+    }
+
     ~HashMap()
     {
         clear();
+        releaseFreeSlots();
         delete[] buckets;
     }
 
@@ -154,11 +461,44 @@ public:
      * @return std::optional<V> — value if found, otherwise std::nullopt
      *
      * @note Average complexity is O(1), but with many collisions
-     *       can degrade to O(n) within one bucket.
+     *       can degrade to O(n) within one bucket. A hit may reorder its
+     *       chain, see setChainOrder().
      */
     [[nodiscard]] std::optional<V> get(const K &key) const
     {
+        if (sz == 0) return std::nullopt;
+
+        if constexpr (N > 0)
+        {
+            if (isInline())
+            {
+                const InlineEntry<K, V> *entries = small.entries();
+                for (size_t i = 0; i < sz; ++i)
+                {
+                    if (entries[i].key == key) return std::optional<V>(entries[i].value);
+                }
+                return std::nullopt;
+            }
+        }
+
         const size_t h = hasher(key);
+
+        if (chain_order == ChainOrder::SortedByHash)
+        {
+            for (const Node<K, V> *e = buckets[h & (capacity - 1)]; e && e->hash <= h; e = e->next)
+            {
+                if (e->hash == h && e->key == key) return std::optional<V>(e->value);
+            }
+            return std::nullopt;
+        }
+
+        if (chain_order != ChainOrder::Unordered)
+        {
+            const Node<K, V> *e = findReordering(key, h);
+            if (!e) return std::nullopt;
+            return std::optional<V>(e->value);
+        }
+
         const size_t index = h & (capacity - 1);
 
         for (Node<K, V> *e = buckets[index]; e; e = e->next)
@@ -182,23 +522,64 @@ public:
      * @param value the value to associate with the key
      *
      * @note Average complexity is O(1). May call resize() when threshold
-     *       is exceeded.
+     *       is exceeded. A small map moves to the bucket table when its
+     *       (N + 1)-th key is inserted.
      */
     void put(const K &key, const V &value)
     {
+        if constexpr (N > 0)
+        {
+            if (isInline())
+            {
+                InlineEntry<K, V> *entries = small.entries();
+                for (size_t i = 0; i < sz; ++i)
+                {
+                    if (entries[i].key == key)
+                    {
+                        entries[i].value = value;
+                        return;
+                    }
+                }
+                if (sz < N)
+                {
+                    new (&entries[sz]) InlineEntry<K, V>{key, value};
+                    ++sz;
+                    return;
+                }
+                spill();
+            }
+        }
+        if (!buckets) init(capacity);
+
         const size_t h = hasher(key);
         const size_t index = h & (capacity - 1);
 
-        for (Node<K,V> *e = buckets[index]; e; e = e->next)
+        if (chain_order == ChainOrder::SortedByHash)
         {
-            if (e->hash == h && e->key == key)
+            Node<K, V> **link = &buckets[index];
+            for (; *link && (*link)->hash <= h; link = &(*link)->next)
             {
-                e->value = value;
-                return;
+                if ((*link)->hash == h && (*link)->key == key)
+                {
+                    (*link)->value = value;
+                    return;
+                }
             }
+            *link = createNode(key, value, h, *link);
         }
+        else
+        {
+            for (Node<K,V> *e = buckets[index]; e; e = e->next)
+            {
+                if (e->hash == h && e->key == key)
+                {
+                    e->value = value;
+                    return;
+                }
+            }
 
-        buckets[index] = new Node<K, V>(key, value, h, buckets[index]);
+            buckets[index] = createNode(key, value, h, buckets[index]);
+        }
         if (++sz > threshold)
         {
             resize();
@@ -217,18 +598,42 @@ public:
      */
     bool remove(const K &key)
     {
+        if (sz == 0) return false;
+
+        if constexpr (N > 0)
+        {
+            if (isInline())
+            {
+                InlineEntry<K, V> *entries = small.entries();
+                for (size_t i = 0; i < sz; ++i)
+                {
+                    if (entries[i].key == key)
+                    {
+                        if (i != sz - 1) entries[i] = std::move(entries[sz - 1]);
+                        entries[sz - 1].~InlineEntry();
+                        --sz;
+                        return true;
+                    }
+                }
+                return false;
+            }
+        }
+
         const size_t h = hasher(key);
         const size_t index = h & (capacity - 1);
 
         Node<K, V> *prev = nullptr;
 
+        const bool sorted = chain_order == ChainOrder::SortedByHash;
+
         for (Node<K, V> *e = buckets[index]; e; prev = e, e = e->next)
         {
+            if (sorted && e->hash > h) break;
             if (e->hash == h && e->key == key)
             {
                 if (prev) prev->next = e->next;
                 else buckets[index] = e->next;
-                delete e;
+                destroyNode(e);
                 --sz;
                 return true;
             }
@@ -240,13 +645,24 @@ public:
      * @brief Clears the hash map.
      *
      * Removes all elements but keeps current capacity and threshold.
-     * After the call, the map is empty but allocated memory remains.
+     * After the call, the map is empty but allocated memory remains:
+     * node storage is kept and reused by subsequent put() calls, so
+     * refilling the map up to its previous size allocates nothing.
+     *
+     * Nothing is ever returned to the allocator: a map that once grew large
+     * keeps its peak bucket array and node storage after clear(). Call
+     * reset() to release that memory.
      *
      * @note Complexity is O(n), where n is the number of elements.
      * @warning All existing pointers to elements become invalid.
      */
     void clear()
     {
+        if (isInline())
+        {
+            destroyInline();
+            return;
+        }
         if (!buckets || sz == 0) return;
         for (size_t i = 0; i < capacity; ++i)
         {
@@ -254,7 +670,7 @@ public:
             while (curr)
             {
                 Node<K, V> *temp = curr->next;
-                delete curr;
+                recycleNode(curr);
                 curr = temp;
             }
             buckets[i] = nullptr;
@@ -265,18 +681,24 @@ public:
     /**
      * @brief Resets the hash map completely.
      *
-     * Removes all elements and frees the bucket array,
-     * then reinitializes the map with default parameters.
-     * Equivalent to the default constructor state.
+     * Removes all elements, frees the bucket array and node storage kept by
+     * clear() and restores default parameters. Equivalent to the default
+     * constructor state: nothing stays allocated and a small map returns to
+     * inline mode.
      *
      * @note Useful when you need to free memory and restore initial state.
      * @warning All existing pointers to elements become invalid.
      */
     void reset()
     {
+        if (isInline())
+        {
+            destroyInline();
+            return;
+        }
         if (!buckets)
         {
-            init();
+            releaseFreeSlots();
             return;
         }
         if (sz != 0) {
@@ -286,14 +708,40 @@ public:
                 while (curr)
                 {
                     Node<K, V> *next = curr->next;
-                    delete curr;
+                    destroyNode(curr);
                     curr = next;
                 }
             }
         }
+        releaseFreeSlots();
         delete[] buckets;
         buckets = nullptr;
-        init();
+        capacity = 16;
+        sz = 0;
+        threshold = static_cast<size_t>(capacity * load_factor);
+    }
+
+    /**
+     * @brief Selects how get() reorders chains, ChainOrder::Unordered by default.
+     *
+     * MoveToFront and Transpose keep frequently read keys near the head of
+     * their chains, which shortens hits under skewed access at high load.
+     * SortedByHash keeps chains sorted by the cached hash, so a miss stops
+     * at the first larger hash instead of walking the whole chain; switching
+     * to it sorts the existing chains.
+     *
+     * @warning With MoveToFront or Transpose get() writes to the table, so
+     *          concurrent get() calls need external synchronization.
+     */
+    void setChainOrder(const ChainOrder order)
+    {
+        chain_order = order;
+        sortChains();
+    }
+
+    [[nodiscard]] ChainOrder getChainOrder() const
+    {
+        return chain_order;
     }
 
     /// Returns number of elements
@@ -308,6 +756,273 @@ public:
         return sz == 0;
     }
 
+    /**
+     * @brief Calls fn(key, value) for every element.
+     *
+     * Order is unspecified. The map must not be modified during the call.
+     *
+     * @note Complexity is O(n + capacity).
+     */
+    template <typename F>
+    void forEach(F &&fn) const
+    {
+        if (isInline())
+        {
+            if constexpr (N > 0)
+            {
+                const InlineEntry<K, V> *entries = small.entries();
+                for (size_t i = 0; i < sz; ++i)
+                {
+                    fn(entries[i].key, entries[i].value);
+                }
+            }
+            return;
+        }
+        if (!buckets) return;
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            for (const Node<K, V> *e = buckets[i]; e; e = e->next)
+            {
+                fn(e->key, e->value);
+            }
+        }
+    }
+
+    /**
+     * @brief Writes the map to a binary snapshot file.
+     *
+     * Layout:
+     *
+     *     "HMSN" | uint32 version | uint64 capacity | uint64 size
+     *     | float load_factor | size x (uint64 hash | key | value)
+     *
+     * Entries are written in bucket order with their cached hashes. Keys
+     * and values are encoded with Codec<T> (raw bytes for trivially
+     * copyable types, length-prefixed std::string).
+     *
+     * @param path file to create or truncate
+     * @return true if the whole snapshot was written
+     *
+     * @note Complexity is O(n + capacity).
+     */
+    bool save(const std::string &path) const
+    {
+        BinaryWriter out(path);
+        out.writeBytes(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        out.writePod(SNAPSHOT_VERSION);
+        out.writePod(static_cast<uint64_t>(capacity));
+        out.writePod(static_cast<uint64_t>(sz));
+        out.writePod(load_factor);
+
+        if (isInline())
+        {
+            if constexpr (N > 0)
+            {
+                const InlineEntry<K, V> *entries = small.entries();
+                for (size_t i = 0; i < sz; ++i)
+                {
+                    out.writePod(static_cast<uint64_t>(hasher(entries[i].key)));
+                    Codec<K>::write(out, entries[i].key);
+                    Codec<V>::write(out, entries[i].value);
+                }
+            }
+        }
+        else if (buckets)
+        {
+            for (size_t i = 0; i < capacity; ++i)
+            {
+                for (const Node<K, V> *e = buckets[i]; e; e = e->next)
+                {
+                    out.writePod(static_cast<uint64_t>(e->hash));
+                    Codec<K>::write(out, e->key);
+                    Codec<V>::write(out, e->value);
+                }
+            }
+        }
+        return out.close();
+    }
+
+    /**
+     * @brief Replaces the contents of the map with a snapshot written by save().
+     *
+     * The bucket array is allocated once with the stored capacity and every
+     * node is linked straight into its bucket using the stored hash, so
+     * neither the hasher nor resize() is called. The stored hash of the
+     * first entry is verified against this build's std::hash; if it differs
+     * (snapshot from another platform or standard library), all hashes are
+     * recomputed instead.
+     *
+     * Counts, capacities and string lengths read from the file are checked
+     * against the remaining file size, and the load factor against
+     * [SNAPSHOT_MIN_LOAD_FACTOR, SNAPSHOT_MAX_LOAD_FACTOR], before anything
+     * is allocated, so a corrupt snapshot fails the load instead of
+     * throwing or resizing without bound.
+     *
+     * Requires default constructible K and V.
+     *
+     * @param path snapshot file
+     * @return true on success; on failure the map is left empty
+     *
+     * @note Complexity is O(n + capacity).
+     */
+    bool load(const std::string &path)
+    {
+        reset();
+        BinaryReader in(path);
+        char magic[sizeof(SNAPSHOT_MAGIC)];
+        uint32_t version = 0;
+        uint64_t cap = 0;
+        uint64_t count = 0;
+        float lf = 0;
+        if (!in.readBytes(magic, sizeof(magic))
+            || !std::equal(magic, magic + sizeof(magic), SNAPSHOT_MAGIC)
+            || !in.readPod(version) || version != SNAPSHOT_VERSION
+            || !in.readPod(cap) || !in.readPod(count) || !in.readPod(lf)
+            || cap == 0 || (cap & (cap - 1)) != 0
+            || !(lf >= SNAPSHOT_MIN_LOAD_FACTOR && lf <= SNAPSHOT_MAX_LOAD_FACTOR)
+            || count > in.remaining() / sizeof(uint64_t))
+        {
+            return false;
+        }
+        // Every entry stores an 8-byte hash, so a bucket per remaining byte is
+        // more than the file can fill; larger (corrupt) capacities are clamped
+        cap = std::min<uint64_t>(cap, std::bit_ceil(std::max<uint64_t>(in.remaining(), 16)));
+
+        load_factor = lf;
+        threshold = static_cast<size_t>(capacity * load_factor);
+        if (N > 0 && count <= N)
+        {
+            // Fits inline, hashes are not needed
+            for (uint64_t i = 0; i < count; ++i)
+            {
+                uint64_t h;
+                K key{};
+                V value{};
+                if (!in.readPod(h) || !Codec<K>::read(in, key) || !Codec<V>::read(in, value))
+                {
+                    reset();
+                    return false;
+                }
+                put(key, value);
+            }
+            return true;
+        }
+
+        init(cap);
+        bool rehash = false;
+        size_t tail_index = capacity;
+        Node<K, V> *tail = nullptr;
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            uint64_t stored;
+            K key{};
+            V value{};
+            if (!in.readPod(stored) || !Codec<K>::read(in, key) || !Codec<V>::read(in, value))
+            {
+                reset();
+                return false;
+            }
+            if (i == 0) rehash = hasher(key) != static_cast<size_t>(stored);
+            const size_t h = rehash ? hasher(key) : static_cast<size_t>(stored);
+            const size_t index = h & (capacity - 1);
+
+            // Entries of one saved bucket arrive together: link each right
+            // behind its predecessor to keep chain order. With a clamped
+            // capacity or recomputed hashes the runs of several saved buckets
+            // share a chain, so the predecessor need not be the last node
+            Node<K, V> *e = createNode(std::move(key), std::move(value), h, nullptr);
+            if (index == tail_index)
+            {
+                e->next = tail->next;
+                tail->next = e;
+            }
+            else
+            {
+                e->next = buckets[index];
+                buckets[index] = e;
+            }
+            tail_index = index;
+            tail = e;
+            ++sz;
+        }
+        sortChains();
+        while (sz > threshold)
+        {
+            resize();
+        }
+        return true;
+    }
+
+};
+
+/**
+ * @brief Low-level access to the bucket table of a HashMap.
+ *
+ * For bulk builders that create nodes themselves (for example on several
+ * threads) and link them into a pre-sized table using the cached hashes.
+ * Nodes linked this way must be allocated with plain `new Node<K, V>`,
+ * the map frees them like its own.
+ *
+ * The read accessors serve writers that walk the table bucket by bucket.
+ * They are meaningful only for maps that are not in small-map mode.
+ */
+template <typename K, typename V, size_t N>
+struct HashMapInternals
+{
+    using Map = HashMap<K, V, N>;
+
+    /**
+     * @brief Empties @p map and allocates a bucket table for @p count elements.
+     *
+     * The capacity stops doubling at the largest power of two, so a huge
+     * @p count fails the allocation instead of looping forever.
+     *
+     * @return the bucket array, its length is capacity(map)
+     */
+    static Node<K, V> **prepare(Map &map, const size_t count)
+    {
+        map.reset();
+        size_t cap = map.capacity;
+        while (static_cast<size_t>(cap * map.load_factor) < count && cap <= SIZE_MAX / 2)
+        {
+            cap *= 2;
+        }
+        map.init(cap);
+        return map.buckets;
+    }
+
+    [[nodiscard]] static size_t capacity(const Map &map)
+    {
+        return map.capacity;
+    }
+
+    /// Bucket array, nullptr until the first put()
+    [[nodiscard]] static const Node<K, V> *const *buckets(const Map &map)
+    {
+        return map.buckets;
+    }
+
+    /// Size above which the next insert resizes the table
+    [[nodiscard]] static size_t threshold(const Map &map)
+    {
+        return map.threshold;
+    }
+
+    [[nodiscard]] static float loadFactor(const Map &map)
+    {
+        return map.load_factor;
+    }
+
+    /// Sets the element count after nodes were linked into the table
+    static void setSize(Map &map, const size_t sz)
+    {
+        map.sortChains();
+        map.sz = sz;
+        while (map.sz > map.threshold)
+        {
+            map.resize();
+        }
+    }
 };
 
 #endif //CPPHASHMAP_HASHMAP_H
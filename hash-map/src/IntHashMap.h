@@ -0,0 +1,306 @@
+#ifndef CPPHASHMAP_INTHASHMAP_H
+#define CPPHASHMAP_INTHASHMAP_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "HashMap.h"
+
+/**
+ * @file IntHashMap.h
+ * @brief Open-addressing hash map for integer keys.
+ *
+ * Keys and values live in two flat arrays of the same capacity (a power of
+ * two), with no nodes, no next pointers and no stored hashes:
+ *
+ *     keys   | k0 | EMPTY | k2 | k3 | EMPTY | ...
+ *     values | v0 |       | v2 | v3 |       | ...
+ *
+ * An empty slot holds the sentinel key EMPTY (the largest value of K). The
+ * sentinel itself is still a valid key: it is stored outside the arrays.
+ *
+ * The slot of a key is taken from the high bits of key * 2^64 / phi
+ * (Fibonacci hashing), collisions probe linearly. remove() shifts the
+ * following entries back instead of leaving tombstones, so lookups stop at
+ * the first empty slot.
+ *
+ * The table doubles once size exceeds 0.75 x capacity. Memory per entry is
+ * (sizeof(K) + sizeof(V)) / load, e.g. about 11-21 bytes for int -> int,
+ * compared with a 24-byte node plus an 8-byte bucket pointer in HashMap.
+ */
+
+template <typename K, typename V>
+class IntHashMap
+{
+    static_assert(std::is_integral_v<K>, "IntHashMap requires an integer key type");
+
+    static constexpr K EMPTY = std::numeric_limits<K>::max();
+
+    /// Slot keys, EMPTY for free slots; nullptr until the first put()
+    K *keys = nullptr;
+
+    /// Slot values, constructed only where keys[i] != EMPTY
+    V *values = nullptr;
+
+    /// Number of entries in the arrays (not counting the sentinel key)
+    size_t sz = 0;
+
+    /// Array length, a power of two
+    size_t capacity = 16;
+
+    /// log2(capacity)
+    unsigned bits = 4;
+
+    /// Value of the sentinel key, stored out of line
+    std::optional<V> empty_key_value;
+
+    [[nodiscard]] size_t slot(const K key) const
+    {
+        const uint64_t h = static_cast<uint64_t>(key) * 0x9e3779b97f4a7c15ull;
+        return static_cast<size_t>(h >> (64 - bits));
+    }
+
+    [[nodiscard]] size_t threshold() const
+    {
+        return capacity / 4 * 3;
+    }
+
+    static V *allocateValues(const size_t n)
+    {
+        return static_cast<V *>(::operator new(n * sizeof(V), std::align_val_t{alignof(V)}));
+    }
+
+    static void freeValues(V *p)
+    {
+        ::operator delete(p, std::align_val_t{alignof(V)});
+    }
+
+    /// Destroys live values and frees both arrays
+    void release()
+    {
+        if (!keys) return;
+        if constexpr (!std::is_trivially_destructible_v<V>)
+        {
+            for (size_t i = 0; i < capacity; ++i)
+            {
+                if (keys[i] != EMPTY) values[i].~V();
+            }
+        }
+        delete[] keys;
+        freeValues(values);
+        keys = nullptr;
+        values = nullptr;
+    }
+
+    void init(const size_t cap)
+    {
+        capacity = cap;
+        bits = static_cast<unsigned>(std::countr_zero(cap));
+        keys = new K[cap];
+        std::fill(keys, keys + cap, EMPTY);
+        values = allocateValues(cap);
+    }
+
+    /// Returns the slot of @p key or of the empty slot where it belongs
+    [[nodiscard]] size_t probe(const K key) const
+    {
+        const size_t mask = capacity - 1;
+        size_t i = slot(key);
+        while (keys[i] != key && keys[i] != EMPTY)
+        {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    /// Doubles the arrays and reinserts every entry
+    void resize()
+    {
+        K *old_keys = keys;
+        V *old_values = values;
+        const size_t old_cap = capacity;
+        init(capacity * 2);
+        for (size_t i = 0; i < old_cap; ++i)
+        {
+            if (old_keys[i] == EMPTY) continue;
+            const size_t j = probe(old_keys[i]);
+            keys[j] = old_keys[i];
+            new (&values[j]) V(std::move(old_values[i]));
+            old_values[i].~V();
+        }
+        delete[] old_keys;
+        freeValues(old_values);
+    }
+
+    void takeFrom(IntHashMap &other)
+    {
+        keys = std::exchange(other.keys, nullptr);
+        values = std::exchange(other.values, nullptr);
+        sz = std::exchange(other.sz, 0);
+        capacity = std::exchange(other.capacity, 16);
+        bits = std::exchange(other.bits, 4);
+        empty_key_value = std::move(other.empty_key_value);
+        other.empty_key_value.reset();
+    }
+
+public:
+    IntHashMap() = default;
+
+    IntHashMap(const IntHashMap&) = delete;
+    IntHashMap& operator=(const IntHashMap&) = delete;
+
+    IntHashMap(IntHashMap &&other) noexcept
+    {
+        takeFrom(other);
+    }
+
+    IntHashMap& operator=(IntHashMap &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    ~IntHashMap()
+    {
+        release();
+    }
+
+    /// Same semantics as HashMap::get()
+    [[nodiscard]] std::optional<V> get(const K &key) const
+    {
+        if (key == EMPTY) return empty_key_value;
+        if (sz == 0) return std::nullopt;
+        const size_t i = probe(key);
+        if (keys[i] == EMPTY) return std::nullopt;
+        return std::optional<V>(values[i]);
+    }
+
+    /// Same semantics as HashMap::put()
+    void put(const K &key, const V &value)
+    {
+        if (key == EMPTY)
+        {
+            empty_key_value = value;
+            return;
+        }
+        if (!keys) init(capacity);
+        size_t i = probe(key);
+        if (keys[i] == key)
+        {
+            values[i] = value;
+            return;
+        }
+        if (sz + 1 > threshold())
+        {
+            resize();
+            i = probe(key);
+        }
+        new (&values[i]) V(value);
+        keys[i] = key;
+        ++sz;
+    }
+
+    /**
+     * @brief Removes an element by key.
+     *
+     * Entries after the freed slot are shifted back (backward-shift
+     * deletion), so no tombstones are left.
+     */
+    bool remove(const K &key)
+    {
+        if (key == EMPTY)
+        {
+            const bool had = empty_key_value.has_value();
+            empty_key_value.reset();
+            return had;
+        }
+        if (sz == 0) return false;
+        const size_t mask = capacity - 1;
+        size_t hole = probe(key);
+        if (keys[hole] == EMPTY) return false;
+        values[hole].~V();
+
+        for (size_t i = (hole + 1) & mask; keys[i] != EMPTY; i = (i + 1) & mask)
+        {
+            // Entry i may fill the hole unless its home slot lies in (hole, i]
+            const size_t home = slot(keys[i]);
+            if (((i - home) & mask) < ((i - hole) & mask)) continue;
+            keys[hole] = keys[i];
+            new (&values[hole]) V(std::move(values[i]));
+            values[i].~V();
+            hole = i;
+        }
+        keys[hole] = EMPTY;
+        --sz;
+        return true;
+    }
+
+    /// Removes all elements, keeps the arrays
+    void clear()
+    {
+        empty_key_value.reset();
+        if (!keys || sz == 0) return;
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            if (keys[i] == EMPTY) continue;
+            values[i].~V();
+            keys[i] = EMPTY;
+        }
+        sz = 0;
+    }
+
+    /// Removes all elements and frees the arrays
+    void reset()
+    {
+        release();
+        empty_key_value.reset();
+        sz = 0;
+        capacity = 16;
+        bits = 4;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return sz + empty_key_value.has_value();
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /// Calls fn(key, value) for every element, in unspecified order
+    template <typename F>
+    void forEach(F &&fn) const
+    {
+        if (empty_key_value) fn(EMPTY, *empty_key_value);
+        if (!keys) return;
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            if (keys[i] != EMPTY) fn(keys[i], values[i]);
+        }
+    }
+};
+
+/**
+ * @brief Picks the map implementation for a key type.
+ *
+ * IntHashMap for integer keys (except bool), HashMap otherwise. Use it
+ * where the code needs only the common get/put/remove/clear/reset/size/
+ * empty/forEach interface.
+ */
+template <typename K, typename V>
+using AutoHashMap = std::conditional_t<std::is_integral_v<K> && !std::is_same_v<K, bool>,
+                                       IntHashMap<K, V>, HashMap<K, V>>;
+
+#endif //CPPHASHMAP_INTHASHMAP_H
@@ -0,0 +1,442 @@
+#ifndef CPPHASHMAP_MAPPEDHASHMAP_H
+#define CPPHASHMAP_MAPPEDHASHMAP_H
+
+#include <cstdint>
+#include <cstring>
+#include <functional> // std::hash
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "HashMap.h"
+#include "Serialization.h"
+
+/**
+ * @file MappedHashMap.h
+ * @brief Read-only hash table served directly from a memory-mapped file.
+ *
+ * write() stores a HashMap in a position-independent layout where every
+ * link is a byte offset from the start of the file instead of a Node*:
+ *
+ *     header | bucket array (capacity x uint64) | nodes | string data
+ *
+ *     node = uint64 hash | uint64 next | key slot | value slot
+ *
+ * Offset 0 marks an empty bucket or the end of a chain (0 always points
+ * into the header). Nodes of one bucket are stored contiguously.
+ *
+ * open() only maps the file and validates the header, lookups then walk
+ * the mapping directly: startup is O(1) and the page cache is shared by
+ * all processes that map the same file. Every offset is checked against
+ * its section before it is followed, so a corrupt file makes lookups miss
+ * instead of reading outside the mapping.
+ *
+ * Slots are described by MappedCodec<T>: trivially copyable types are
+ * stored inline, std::string as (offset, length) into the string data.
+ *
+ * Files use native endianness and this build's std::hash; open() refuses
+ * a file whose stored hashes do not match.
+ */
+
+template <typename T, typename = void>
+struct MappedCodec;
+
+/// Inline storage for trivially copyable types
+template <typename T>
+struct MappedCodec<T, std::enable_if_t<std::is_trivially_copyable_v<T>>>
+{
+    using Slot = T;
+
+    static Slot store(const T &value, uint64_t &)
+    {
+        return value;
+    }
+
+    static void writeData(BinaryWriter &, const T &) {}
+
+    static bool equals(const Slot &slot, const char *, const T &value)
+    {
+        return slot == value;
+    }
+
+    static T load(const Slot &slot, const char *)
+    {
+        return slot;
+    }
+
+    static bool valid(const Slot &, uint64_t, uint64_t)
+    {
+        return true;
+    }
+};
+
+/// (offset, length) into the string data section
+template <>
+struct MappedCodec<std::string>
+{
+    struct Slot
+    {
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    /// Assigns the next position of the string data section to @p value
+    static Slot store(const std::string &value, uint64_t &data_end)
+    {
+        const Slot slot{data_end, value.size()};
+        data_end += value.size();
+        return slot;
+    }
+
+    static void writeData(BinaryWriter &out, const std::string &value)
+    {
+        out.writeBytes(value.data(), value.size());
+    }
+
+    static bool equals(const Slot &slot, const char *base, const std::string &value)
+    {
+        return slot.length == value.size()
+               && std::memcmp(base + slot.offset, value.data(), value.size()) == 0;
+    }
+
+    static std::string load(const Slot &slot, const char *base)
+    {
+        return std::string(base + slot.offset, slot.length);
+    }
+
+    /// Checks that the string lies inside the data section [begin, end)
+    static bool valid(const Slot &slot, const uint64_t begin, const uint64_t end)
+    {
+        return slot.offset >= begin && slot.offset <= end && slot.length <= end - slot.offset;
+    }
+};
+
+inline constexpr char MAPPED_MAGIC[4] = {'H', 'M', 'M', 'P'};
+inline constexpr uint32_t MAPPED_VERSION = 1;
+
+template <typename K, typename V>
+class MappedHashMap
+{
+    using KeyCodec = MappedCodec<K>;
+    using ValueCodec = MappedCodec<V>;
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t capacity;
+        uint64_t size;
+        uint64_t buckets_offset;
+        uint64_t nodes_offset;
+        uint64_t data_offset;
+        uint64_t file_size;
+        uint32_t node_size;
+        uint32_t reserved;
+    };
+
+    struct MappedNode
+    {
+        uint64_t hash;
+        uint64_t next;
+        typename KeyCodec::Slot key;
+        typename ValueCodec::Slot value;
+    };
+
+    static_assert(std::is_trivially_copyable_v<MappedNode>);
+
+    /// Start of the mapping, nullptr when closed
+    const char *base = nullptr;
+
+    /// Length of the mapping
+    size_t length = 0;
+
+    /// Cached header fields
+    size_t capacity = 0;
+    size_t sz = 0;
+    const uint64_t *buckets = nullptr;
+    uint64_t nodes_offset = 0;
+    uint64_t data_offset = 0;
+
+    /// Hash function, must match the one used by write()
+    std::hash<K> hasher;
+
+    static uint64_t alignUp(const uint64_t value, const uint64_t align)
+    {
+        return (value + align - 1) / align * align;
+    }
+
+    [[nodiscard]] const MappedNode *node(const uint64_t offset) const
+    {
+        return reinterpret_cast<const MappedNode *>(base + offset);
+    }
+
+    /// Checks that @p offset is the start of a node of the node section
+    [[nodiscard]] bool validNode(const uint64_t offset) const
+    {
+        return offset >= nodes_offset && offset < data_offset
+               && (offset - nodes_offset) % sizeof(MappedNode) == 0;
+    }
+
+public:
+    MappedHashMap() = default;
+
+    MappedHashMap(const MappedHashMap&) = delete;
+    MappedHashMap& operator=(const MappedHashMap&) = delete;
+
+    MappedHashMap(MappedHashMap &&other) noexcept
+        : base(other.base), length(other.length), capacity(other.capacity),
+          sz(other.sz), buckets(other.buckets),
+          nodes_offset(other.nodes_offset), data_offset(other.data_offset)
+    {
+        other.base = nullptr;
+        other.close();
+    }
+
+    MappedHashMap &operator=(MappedHashMap &&other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            std::swap(base, other.base);
+            std::swap(length, other.length);
+            std::swap(capacity, other.capacity);
+            std::swap(sz, other.sz);
+            std::swap(buckets, other.buckets);
+            std::swap(nodes_offset, other.nodes_offset);
+            std::swap(data_offset, other.data_offset);
+        }
+        return *this;
+    }
+
+    ~MappedHashMap()
+    {
+        close();
+    }
+
+    /**
+     * @brief Writes @p map to @p path in the mappable layout.
+     *
+     * The bucket count is the smallest power of two (at least 16) that keeps
+     * the load factor at or below 0.75.
+     *
+     * @return true if the whole file was written
+     *
+     * @note Complexity is O(n + capacity), the entries are bucketed with a
+     *       counting sort.
+     */
+    template <size_t N>
+    static bool write(const HashMap<K, V, N> &map, const std::string &path)
+    {
+        struct Entry
+        {
+            uint64_t hash;
+            const K *key;
+            const V *value;
+        };
+
+        std::hash<K> hasher;
+        std::vector<Entry> entries;
+        entries.reserve(map.size());
+        map.forEach([&](const K &key, const V &value)
+        {
+            entries.push_back({static_cast<uint64_t>(hasher(key)), &key, &value});
+        });
+
+        uint64_t cap = 16;
+        while (static_cast<double>(entries.size()) > static_cast<double>(cap) * 0.75)
+        {
+            cap *= 2;
+        }
+
+        // Counting sort by bucket index
+        std::vector<uint64_t> start(cap + 1, 0);
+        for (const Entry &e : entries) ++start[(e.hash & (cap - 1)) + 1];
+        for (uint64_t i = 0; i < cap; ++i) start[i + 1] += start[i];
+        std::vector<Entry> sorted(entries.size());
+        {
+            std::vector<uint64_t> fill(start.begin(), start.end() - 1);
+            for (const Entry &e : entries) sorted[fill[e.hash & (cap - 1)]++] = e;
+        }
+
+        Header header{};
+        std::memcpy(header.magic, MAPPED_MAGIC, sizeof(MAPPED_MAGIC));
+        header.version = MAPPED_VERSION;
+        header.capacity = cap;
+        header.size = sorted.size();
+        header.buckets_offset = alignUp(sizeof(Header), 8);
+        header.nodes_offset = alignUp(header.buckets_offset + cap * sizeof(uint64_t), alignof(MappedNode));
+        header.data_offset = header.nodes_offset + sorted.size() * sizeof(MappedNode);
+        header.node_size = sizeof(MappedNode);
+
+        // String data positions are assigned in node order
+        uint64_t data_end = header.data_offset;
+        std::vector<MappedNode> nodes(sorted.size());
+        for (size_t i = 0; i < sorted.size(); ++i)
+        {
+            MappedNode &n = nodes[i];
+            std::memset(static_cast<void *>(&n), 0, sizeof(n));
+            n.hash = sorted[i].hash;
+            const bool chained = i + 1 < sorted.size()
+                                 && ((sorted[i + 1].hash ^ n.hash) & (cap - 1)) == 0;
+            n.next = chained ? header.nodes_offset + (i + 1) * sizeof(MappedNode) : 0;
+            n.key = KeyCodec::store(*sorted[i].key, data_end);
+            n.value = ValueCodec::store(*sorted[i].value, data_end);
+        }
+        header.file_size = data_end;
+
+        BinaryWriter out(path);
+        out.writePod(header);
+        for (uint64_t pos = sizeof(Header); pos < header.buckets_offset; ++pos) out.writePod('\0');
+        for (uint64_t i = 0; i < cap; ++i)
+        {
+            const uint64_t head = start[i] != start[i + 1]
+                                  ? header.nodes_offset + start[i] * sizeof(MappedNode)
+                                  : 0;
+            out.writePod(head);
+        }
+        for (uint64_t pos = header.buckets_offset + cap * sizeof(uint64_t); pos < header.nodes_offset; ++pos)
+        {
+            out.writePod('\0');
+        }
+        out.writeBytes(nodes.data(), nodes.size() * sizeof(MappedNode));
+        for (const Entry &e : sorted)
+        {
+            KeyCodec::writeData(out, *e.key);
+            ValueCodec::writeData(out, *e.value);
+        }
+        return out.close();
+    }
+
+    /**
+     * @brief Maps a file written by write().
+     *
+     * Validates the header and section bounds, no entries are read.
+     *
+     * @return true on success; on failure the map stays closed
+     */
+    bool open(const std::string &path)
+    {
+        close();
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header))
+        {
+            ::close(fd);
+            return false;
+        }
+        void *mem = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mem == MAP_FAILED) return false;
+        base = static_cast<const char *>(mem);
+        length = st.st_size;
+
+        Header header;
+        std::memcpy(&header, base, sizeof(Header));
+        // Sections are ordered and inside the file before any size is
+        // multiplied, so none of the bounds below can overflow
+        const bool valid = std::memcmp(header.magic, MAPPED_MAGIC, sizeof(MAPPED_MAGIC)) == 0
+            && header.version == MAPPED_VERSION
+            && header.node_size == sizeof(MappedNode)
+            && header.file_size == length
+            && header.buckets_offset >= sizeof(Header)
+            && header.buckets_offset <= header.nodes_offset
+            && header.nodes_offset <= header.data_offset
+            && header.data_offset <= length
+            && header.buckets_offset % 8 == 0
+            && header.nodes_offset % alignof(MappedNode) == 0
+            && header.capacity != 0 && (header.capacity & (header.capacity - 1)) == 0
+            && header.capacity <= (header.nodes_offset - header.buckets_offset) / sizeof(uint64_t)
+            && header.size == (header.data_offset - header.nodes_offset) / sizeof(MappedNode)
+            && (header.data_offset - header.nodes_offset) % sizeof(MappedNode) == 0;
+        if (!valid)
+        {
+            close();
+            return false;
+        }
+        capacity = header.capacity;
+        sz = header.size;
+        buckets = reinterpret_cast<const uint64_t *>(base + header.buckets_offset);
+        nodes_offset = header.nodes_offset;
+        data_offset = header.data_offset;
+
+        // Stored hashes must come from the same std::hash as ours
+        if (sz != 0)
+        {
+            const MappedNode *first = node(header.nodes_offset);
+            if (!KeyCodec::valid(first->key, data_offset, length)
+                || first->hash != static_cast<uint64_t>(hasher(KeyCodec::load(first->key, base))))
+            {
+                close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Unmaps the file
+    void close()
+    {
+        if (base) munmap(const_cast<char *>(base), length);
+        base = nullptr;
+        length = 0;
+        capacity = 0;
+        sz = 0;
+        buckets = nullptr;
+        nodes_offset = 0;
+        data_offset = 0;
+    }
+
+    /**
+     * @brief Returns the value by key.
+     *
+     * Same semantics as HashMap::get(). Walks the mapping directly, values
+     * are copied out only for the result. A link outside the node section,
+     * a chain longer than size() (a cycle) or a string outside the data
+     * section ends the walk as a miss.
+     */
+    [[nodiscard]] std::optional<V> get(const K &key) const
+    {
+        if (sz == 0) return std::nullopt;
+        const size_t h = hasher(key);
+        size_t steps = 0;
+        for (uint64_t off = buckets[h & (capacity - 1)]; off; off = node(off)->next)
+        {
+            if (!validNode(off) || ++steps > sz) return std::nullopt;
+            const MappedNode *e = node(off);
+            if (e->hash == h && KeyCodec::valid(e->key, data_offset, length)
+                && KeyCodec::equals(e->key, base, key))
+            {
+                if (!ValueCodec::valid(e->value, data_offset, length)) return std::nullopt;
+                return std::optional<V>(ValueCodec::load(e->value, base));
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// Returns number of elements
+    [[nodiscard]] size_t size() const
+    {
+        return sz;
+    }
+
+    /// Checks whether the map is empty
+    [[nodiscard]] bool empty() const
+    {
+        return sz == 0;
+    }
+
+    /// Checks whether a file is mapped
+    [[nodiscard]] bool isOpen() const
+    {
+        return base != nullptr;
+    }
+};
+
+#endif //CPPHASHMAP_MAPPEDHASHMAP_H
@@ -0,0 +1,114 @@
+#ifndef CPPHASHMAP_OFFSETCHAIN_H
+#define CPPHASHMAP_OFFSETCHAIN_H
+
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @file OffsetChain.h
+ * @brief Separate chaining with offsets instead of pointers.
+ *
+ * Building block for tables that live in memory-mapped regions, where the
+ * mapping address differs between processes or changes after mremap().
+ * Every link is a byte offset from the start of the node region, 0 means
+ * "no node" (the region must keep offset 0 for a header).
+ *
+ * The bucket array is a plain uint64_t array of head offsets and may live
+ * in the same region or in a separate one.
+ */
+
+template <typename K, typename V>
+struct OffsetNode
+{
+    /// Hash of the key, stored to avoid recalculating
+    uint64_t hash;
+
+    /// Offset of the next node in the chain, 0 at the end
+    uint64_t next;
+
+    K key;
+    V value;
+};
+
+template <typename K, typename V>
+struct OffsetChain
+{
+    static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                  "offset-based tables store keys and values as raw bytes");
+
+    using NodeT = OffsetNode<K, V>;
+
+    [[nodiscard]] static NodeT *node(char *base, const uint64_t offset)
+    {
+        return reinterpret_cast<NodeT *>(base + offset);
+    }
+
+    [[nodiscard]] static const NodeT *node(const char *base, const uint64_t offset)
+    {
+        return reinterpret_cast<const NodeT *>(base + offset);
+    }
+
+    /// Returns the offset of the node holding @p key in chain @p head, or 0
+    [[nodiscard]] static uint64_t find(const char *base, uint64_t head, const K &key, const uint64_t h)
+    {
+        while (head)
+        {
+            const NodeT *e = node(base, head);
+            if (e->hash == h && e->key == key) return head;
+            head = e->next;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Unlinks the node holding @p key from the chain starting at @p head.
+     *
+     * @return offset of the unlinked node, or 0 if not found
+     */
+    static uint64_t unlink(char *base, uint64_t &head, const K &key, const uint64_t h)
+    {
+        uint64_t *link = &head;
+        while (*link)
+        {
+            NodeT *e = node(base, *link);
+            if (e->hash == h && e->key == key)
+            {
+                const uint64_t found = *link;
+                *link = e->next;
+                return found;
+            }
+            link = &e->next;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Splits every chain of a table that has just doubled.
+     *
+     * Buckets [0, old_cap) hold all nodes; [old_cap, 2 * old_cap) must be 0.
+     * Nodes whose hash has the old_cap bit set move to bucket i + old_cap.
+     * Relative order within each chain is preserved.
+     */
+    static void split(char *base, uint64_t *buckets, const uint64_t old_cap)
+    {
+        for (uint64_t i = 0; i < old_cap; ++i)
+        {
+            uint64_t *low = &buckets[i];
+            uint64_t *high = &buckets[i + old_cap];
+            uint64_t curr = buckets[i];
+            while (curr)
+            {
+                NodeT *e = node(base, curr);
+                const uint64_t next = e->next;
+                uint64_t *&tail = (e->hash & old_cap) ? high : low;
+                *tail = curr;
+                tail = &e->next;
+                curr = next;
+            }
+            *low = 0;
+            *high = 0;
+        }
+    }
+};
+
+#endif //CPPHASHMAP_OFFSETCHAIN_H
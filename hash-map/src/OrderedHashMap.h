@@ -0,0 +1,275 @@
+#ifndef CPPHASHMAP_ORDEREDHASHMAP_H
+#define CPPHASHMAP_ORDEREDHASHMAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional> // std::hash
+#include <optional>
+#include <utility>
+#include <vector>
+
+/**
+ * @file OrderedHashMap.h
+ * @brief Insertion-ordered hash map with a compact index (CPython dict layout).
+ *
+ * Two arrays instead of buckets and nodes:
+ *  - entries — dense vector of (hash, key, value) in insertion order;
+ *  - index   — open-addressing table of entry numbers, stored in 1, 2, 4 or
+ *    8 bytes per slot depending on the table size.
+ *
+ *     index   | 2 | - | 0 | - | 1 | - | - | 3 |
+ *     entries | (h, "b", 2) | (h, "c", 3) | (h, "a", 1) | (h, "d", 4) |
+ *
+ * forEach() is a linear scan of entries in insertion order. Updating a key
+ * keeps its position, removing it leaves a hole that is squeezed out at the
+ * next rebuild; a removed and re-inserted key goes to the end.
+ *
+ * The index holds at most 2/3 used slots (including removed ones) and is
+ * probed linearly. Entries store the hash mixed by a Fibonacci multiply
+ * (std::hash of an integer is the identity), so keys that share their low
+ * bits do not pile up in one probe run. An int -> int entry takes 16 bytes
+ * plus 1.5-3 index slots of 1-4 bytes, against a 24-byte heap node and a
+ * bucket pointer in HashMap.
+ */
+
+template <typename K, typename V>
+class OrderedHashMap
+{
+    struct Entry
+    {
+        size_t hash;
+        K key;
+        V value;
+    };
+
+    /// Index slot values; entry i is stored as i + FIRST_ENTRY
+    static constexpr size_t EMPTY = 0;
+    static constexpr size_t REMOVED = 1;
+    static constexpr size_t FIRST_ENTRY = 2;
+
+    static constexpr size_t MIN_CAPACITY = 8;
+
+    /// Entries in insertion order, including removed ones
+    std::vector<Entry> entries;
+
+    /// Marks removed entries
+    std::vector<bool> removed;
+
+    /// Slot table, width bytes per slot
+    std::vector<unsigned char> index;
+
+    /// Bytes per index slot: 1, 2, 4 or 8
+    unsigned width = 1;
+
+    /// Number of index slots, a power of two (0 before the first put)
+    size_t capacity = 0;
+
+    /// Number of live entries
+    size_t sz = 0;
+
+    std::hash<K> hasher;
+
+    /// std::hash mixed so that its low bits depend on every bit of the key
+    [[nodiscard]] size_t hashOf(const K &key) const
+    {
+        uint64_t m = static_cast<uint64_t>(hasher(key)) * 0x9e3779b97f4a7c15ull;
+        m ^= m >> 32;
+        return static_cast<size_t>(m);
+    }
+
+    [[nodiscard]] size_t slot(const size_t i) const
+    {
+        const unsigned char *p = index.data() + i * width;
+        switch (width)
+        {
+            case 1: return *p;
+            case 2: { uint16_t v; std::memcpy(&v, p, 2); return v; }
+            case 4: { uint32_t v; std::memcpy(&v, p, 4); return v; }
+            default: { uint64_t v; std::memcpy(&v, p, 8); return v; }
+        }
+    }
+
+    void setSlot(const size_t i, const size_t value)
+    {
+        unsigned char *p = index.data() + i * width;
+        switch (width)
+        {
+            case 1: *p = static_cast<unsigned char>(value); break;
+            case 2: { const auto v = static_cast<uint16_t>(value); std::memcpy(p, &v, 2); break; }
+            case 4: { const auto v = static_cast<uint32_t>(value); std::memcpy(p, &v, 4); break; }
+            default: { const uint64_t v = value; std::memcpy(p, &v, 8); break; }
+        }
+    }
+
+    /// Maximum entries (live and removed) before a rebuild
+    [[nodiscard]] size_t usable() const
+    {
+        return capacity / 3 * 2;
+    }
+
+    /**
+     * @brief Finds the index slot of @p key.
+     *
+     * @return slot holding the key, or the first EMPTY slot of its probe
+     *         sequence (then slot(result) == EMPTY)
+     */
+    [[nodiscard]] size_t findSlot(const K &key, const size_t h) const
+    {
+        const size_t mask = capacity - 1;
+        for (size_t i = h & mask;; i = (i + 1) & mask)
+        {
+            const size_t s = slot(i);
+            if (s == EMPTY) return i;
+            if (s == REMOVED) continue;
+            const Entry &e = entries[s - FIRST_ENTRY];
+            if (e.hash == h && e.key == key) return i;
+        }
+    }
+
+    /// Drops removed entries and rebuilds an index sized for @p min_entries
+    void rebuild(const size_t min_entries)
+    {
+        if (sz != entries.size())
+        {
+            size_t out = 0;
+            for (size_t i = 0; i < entries.size(); ++i)
+            {
+                if (removed[i]) continue;
+                if (out != i) entries[out] = std::move(entries[i]);
+                ++out;
+            }
+            entries.resize(out);
+            removed.assign(out, false);
+        }
+
+        capacity = MIN_CAPACITY;
+        while (capacity / 3 * 2 < min_entries) capacity *= 2;
+        const size_t max_value = capacity / 3 * 2 + FIRST_ENTRY;
+        width = max_value <= UINT8_MAX ? 1 : max_value <= UINT16_MAX ? 2 : max_value <= UINT32_MAX ? 4 : 8;
+        index.assign(capacity * width, 0);
+        const size_t mask = capacity - 1;
+        for (size_t e = 0; e < entries.size(); ++e)
+        {
+            size_t i = entries[e].hash & mask;
+            while (slot(i) != EMPTY) i = (i + 1) & mask;
+            setSlot(i, e + FIRST_ENTRY);
+        }
+    }
+
+public:
+    OrderedHashMap() = default;
+
+    OrderedHashMap(const OrderedHashMap&) = delete;
+    OrderedHashMap& operator=(const OrderedHashMap&) = delete;
+
+    OrderedHashMap(OrderedHashMap &&other) noexcept
+        : entries(std::move(other.entries)),
+          removed(std::move(other.removed)),
+          index(std::move(other.index)),
+          width(other.width),
+          capacity(other.capacity),
+          sz(std::exchange(other.sz, 0))
+    {
+        other.reset();
+    }
+
+    OrderedHashMap& operator=(OrderedHashMap &&other) noexcept
+    {
+        if (this != &other)
+        {
+            entries = std::move(other.entries);
+            removed = std::move(other.removed);
+            index = std::move(other.index);
+            width = other.width;
+            capacity = other.capacity;
+            sz = std::exchange(other.sz, 0);
+            other.reset();
+        }
+        return *this;
+    }
+
+    /// Same semantics as HashMap::get()
+    [[nodiscard]] std::optional<V> get(const K &key) const
+    {
+        if (sz == 0) return std::nullopt;
+        const size_t s = slot(findSlot(key, hashOf(key)));
+        if (s == EMPTY) return std::nullopt;
+        return std::optional<V>(entries[s - FIRST_ENTRY].value);
+    }
+
+    /// Same semantics as HashMap::put(); a new key is appended to the order
+    void put(const K &key, const V &value)
+    {
+        const size_t h = hashOf(key);
+        if (capacity != 0)
+        {
+            const size_t s = slot(findSlot(key, h));
+            if (s != EMPTY)
+            {
+                entries[s - FIRST_ENTRY].value = value;
+                return;
+            }
+        }
+        if (entries.size() + 1 > usable()) rebuild(std::max<size_t>(sz * 2, sz + 1));
+        setSlot(findSlot(key, h), entries.size() + FIRST_ENTRY);
+        entries.push_back({h, key, value});
+        removed.push_back(false);
+        ++sz;
+    }
+
+    /// Removes an element by key, the order of the others is kept
+    bool remove(const K &key)
+    {
+        if (sz == 0) return false;
+        const size_t i = findSlot(key, hashOf(key));
+        const size_t s = slot(i);
+        if (s == EMPTY) return false;
+        setSlot(i, REMOVED);
+        removed[s - FIRST_ENTRY] = true;
+        --sz;
+        return true;
+    }
+
+    /// Removes all elements, keeps the allocated arrays
+    void clear()
+    {
+        entries.clear();
+        removed.clear();
+        std::fill(index.begin(), index.end(), 0);
+        sz = 0;
+    }
+
+    /// Removes all elements and frees memory
+    void reset()
+    {
+        std::vector<Entry>().swap(entries);
+        std::vector<bool>().swap(removed);
+        std::vector<unsigned char>().swap(index);
+        capacity = 0;
+        width = 1;
+        sz = 0;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return sz;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return sz == 0;
+    }
+
+    /// Calls fn(key, value) for every element, in insertion order
+    template <typename F>
+    void forEach(F &&fn) const
+    {
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            if (!removed[i]) fn(entries[i].key, entries[i].value);
+        }
+    }
+};
+
+#endif //CPPHASHMAP_ORDEREDHASHMAP_H
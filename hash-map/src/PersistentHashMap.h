@@ -0,0 +1,420 @@
+#ifndef CPPHASHMAP_PERSISTENTHASHMAP_H
+#define CPPHASHMAP_PERSISTENTHASHMAP_H
+
+#include <cstdint>
+#include <cstring>
+#include <functional> // std::hash
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "OffsetChain.h"
+
+/**
+ * @file PersistentHashMap.h
+ * @brief Mutable hash map stored in memory-mapped files.
+ *
+ * The map consists of two files:
+ *  - `path`      — header followed by the node arena;
+ *  - `path.idx`  — the bucket array (uint64 offsets into the arena).
+ *
+ * Nodes are linked by offsets (see OffsetChain.h), so the files are valid at
+ * any mapping address and the map is usable right after open() without a
+ * load step. The kernel pages data in and out, so the map may be larger
+ * than RAM.
+ *
+ * Growth:
+ *  - the arena file doubles with ftruncate() + mremap() when it is full;
+ *  - the bucket file doubles the same way once size exceeds 0.75 x capacity,
+ *    then every chain is split in place into buckets i and i + old capacity.
+ *    The header records the growth while it runs; if the process dies in
+ *    between, open() relinks every live node into a table of the bucket
+ *    file's size.
+ *
+ * Removed nodes go to a free list inside the arena and are reused by put().
+ * Keys and values must be trivially copyable. Data reaches the disk when the
+ * kernel writes back dirty pages, flush() forces it (msync).
+ */
+
+inline constexpr char PERSISTENT_MAGIC[4] = {'H', 'M', 'P', 'F'};
+inline constexpr uint32_t PERSISTENT_VERSION = 2;
+
+template <typename K, typename V>
+class PersistentHashMap
+{
+    using Chain = OffsetChain<K, V>;
+    using NodeT = typename Chain::NodeT;
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t node_size;
+        uint32_t node_align;
+        uint64_t hash_check;
+        uint64_t capacity;
+        uint64_t size;
+        uint64_t arena_end;
+        uint64_t free_head;
+
+        /// Capacity before a growBuckets() that has not finished, 0 otherwise
+        uint64_t growing_from;
+    };
+
+    static constexpr uint64_t ARENA_START = (sizeof(Header) + alignof(NodeT) - 1) / alignof(NodeT) * alignof(NodeT);
+    static constexpr float LOAD_FACTOR = 0.75f;
+
+    /// Arena mapping (header + nodes)
+    char *base = nullptr;
+    size_t base_len = 0;
+    int base_fd = -1;
+
+    /// Bucket mapping
+    uint64_t *buckets = nullptr;
+    size_t buckets_len = 0;
+    int buckets_fd = -1;
+
+    /// Sticky I/O error flag
+    bool good = false;
+
+    std::hash<K> hasher;
+
+    [[nodiscard]] Header &header() const
+    {
+        return *reinterpret_cast<Header *>(base);
+    }
+
+    /// Hash of a value-initialized key, detects files written with another std::hash
+    [[nodiscard]] uint64_t hashCheck() const
+    {
+        return hasher(K{});
+    }
+
+    /// Resizes file @p fd to @p len and remaps @p mem (which may move)
+    static bool growMapping(const int fd, void *&mem, size_t &len, const size_t new_len)
+    {
+        if (::ftruncate(fd, static_cast<off_t>(new_len)) != 0) return false;
+        void *moved = ::mremap(mem, len, new_len, MREMAP_MAYMOVE);
+        if (moved == MAP_FAILED) return false;
+        mem = moved;
+        len = new_len;
+        return true;
+    }
+
+    static void *mapFile(const int fd, const size_t len)
+    {
+        void *mem = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        return mem == MAP_FAILED ? nullptr : mem;
+    }
+
+    /// Returns an arena offset for a new node, growing the arena if needed
+    uint64_t allocateNode()
+    {
+        Header &h = header();
+        if (h.free_head)
+        {
+            const uint64_t off = h.free_head;
+            h.free_head = Chain::node(base, off)->next;
+            return off;
+        }
+        if (h.arena_end + sizeof(NodeT) > base_len)
+        {
+            void *mem = base;
+            if (!growMapping(base_fd, mem, base_len, base_len * 2))
+            {
+                good = false;
+                return 0;
+            }
+            base = static_cast<char *>(mem);
+        }
+        Header &grown = header();
+        const uint64_t off = grown.arena_end;
+        grown.arena_end += sizeof(NodeT);
+        return off;
+    }
+
+    /**
+     * @brief Doubles the bucket file and splits every chain in place.
+     *
+     * growing_from stays set until the new capacity is stored, also when
+     * the file cannot grow, so that the next open() repairs the table.
+     */
+    bool growBuckets()
+    {
+        const uint64_t old_cap = header().capacity;
+        header().growing_from = old_cap;
+        void *mem = buckets;
+        if (!growMapping(buckets_fd, mem, buckets_len, buckets_len * 2)) return false;
+        buckets = static_cast<uint64_t *>(mem);
+        Chain::split(base, buckets, old_cap);
+        header().capacity = old_cap * 2;
+        header().growing_from = 0;
+        return true;
+    }
+
+    /**
+     * @brief Finishes an interrupted growBuckets().
+     *
+     * The bucket file may have its old or its doubled size and chains may be
+     * half split, so the table is rebuilt from the arena: every node that is
+     * not on the free list is live (growth never runs while a node is being
+     * inserted) and is linked into a table of the bucket file's size.
+     *
+     * @return false if the arena does not match the header
+     */
+    bool rebuildBuckets()
+    {
+        Header &h = header();
+        const uint64_t cap = buckets_len / sizeof(uint64_t);
+        if (cap == 0 || (cap & (cap - 1)) != 0 || buckets_len % sizeof(uint64_t) != 0
+            || (h.arena_end - ARENA_START) % sizeof(NodeT) != 0)
+        {
+            return false;
+        }
+        const uint64_t nodes = (h.arena_end - ARENA_START) / sizeof(NodeT);
+        std::vector<bool> is_free(nodes);
+        uint64_t free_count = 0;
+        for (uint64_t off = h.free_head; off; off = Chain::node(base, off)->next)
+        {
+            const uint64_t i = (off - ARENA_START) / sizeof(NodeT);
+            if (off < ARENA_START || i >= nodes || (off - ARENA_START) % sizeof(NodeT) != 0 || is_free[i])
+            {
+                return false;
+            }
+            is_free[i] = true;
+            ++free_count;
+        }
+        if (nodes - free_count != h.size) return false;
+
+        std::memset(buckets, 0, buckets_len);
+        for (uint64_t i = 0; i < nodes; ++i)
+        {
+            if (is_free[i]) continue;
+            const uint64_t off = ARENA_START + i * sizeof(NodeT);
+            NodeT *e = Chain::node(base, off);
+            e->next = buckets[e->hash & (cap - 1)];
+            buckets[e->hash & (cap - 1)] = off;
+        }
+        h.capacity = cap;
+        h.growing_from = 0;
+        return true;
+    }
+
+public:
+    PersistentHashMap() = default;
+
+    PersistentHashMap(const PersistentHashMap&) = delete;
+    PersistentHashMap& operator=(const PersistentHashMap&) = delete;
+
+    ~PersistentHashMap()
+    {
+        close();
+    }
+
+    /**
+     * @brief Opens the map stored at @p path, creating it if missing.
+     *
+     * @param path arena file; buckets are kept in `path + ".idx"`
+     * @param initial_nodes arena capacity of a newly created map
+     * @return false if the files cannot be created or mapped, or belong to a
+     *         map with different K/V types or another std::hash
+     *
+     * @note A bucket table left behind by an interrupted growth is rebuilt,
+     *       which takes O(arena size).
+     */
+    bool open(const std::string &path, const size_t initial_nodes = 1024)
+    {
+        close();
+        base_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        buckets_fd = ::open((path + ".idx").c_str(), O_RDWR | O_CREAT, 0644);
+        if (base_fd < 0 || buckets_fd < 0)
+        {
+            close();
+            return false;
+        }
+
+        struct stat st{};
+        if (fstat(base_fd, &st) != 0)
+        {
+            close();
+            return false;
+        }
+        const bool created = st.st_size == 0;
+        if (created)
+        {
+            const uint64_t cap = 16;
+            base_len = ARENA_START + (initial_nodes ? initial_nodes : 1) * sizeof(NodeT);
+            buckets_len = cap * sizeof(uint64_t);
+            if (::ftruncate(base_fd, static_cast<off_t>(base_len)) != 0
+                || ::ftruncate(buckets_fd, static_cast<off_t>(buckets_len)) != 0)
+            {
+                close();
+                return false;
+            }
+        }
+        else
+        {
+            base_len = st.st_size;
+            struct stat idx{};
+            if (fstat(buckets_fd, &idx) != 0 || base_len < ARENA_START)
+            {
+                close();
+                return false;
+            }
+            buckets_len = idx.st_size;
+        }
+
+        base = static_cast<char *>(mapFile(base_fd, base_len));
+        buckets = static_cast<uint64_t *>(mapFile(buckets_fd, buckets_len));
+        if (!base || !buckets)
+        {
+            close();
+            return false;
+        }
+
+        Header &h = header();
+        if (created)
+        {
+            std::memcpy(h.magic, PERSISTENT_MAGIC, sizeof(PERSISTENT_MAGIC));
+            h.version = PERSISTENT_VERSION;
+            h.node_size = sizeof(NodeT);
+            h.node_align = alignof(NodeT);
+            h.hash_check = hashCheck();
+            h.capacity = buckets_len / sizeof(uint64_t);
+            h.size = 0;
+            h.arena_end = ARENA_START;
+            h.free_head = 0;
+            h.growing_from = 0;
+        }
+        else if (std::memcmp(h.magic, PERSISTENT_MAGIC, sizeof(PERSISTENT_MAGIC)) != 0
+                 || h.version != PERSISTENT_VERSION
+                 || h.node_size != sizeof(NodeT)
+                 || h.node_align != alignof(NodeT)
+                 || h.hash_check != hashCheck()
+                 || h.arena_end > base_len || h.arena_end < ARENA_START
+                 || (h.growing_from == 0 && h.capacity * sizeof(uint64_t) != buckets_len)
+                 || (h.growing_from != 0 && !rebuildBuckets()))
+        {
+            close();
+            return false;
+        }
+        good = true;
+        return true;
+    }
+
+    /// Flushes and unmaps both files
+    void close()
+    {
+        if (base && buckets) flush();
+        if (base) ::munmap(base, base_len);
+        if (buckets) ::munmap(buckets, buckets_len);
+        if (base_fd >= 0) ::close(base_fd);
+        if (buckets_fd >= 0) ::close(buckets_fd);
+        base = nullptr;
+        buckets = nullptr;
+        base_len = buckets_len = 0;
+        base_fd = buckets_fd = -1;
+        good = false;
+    }
+
+    /// Writes dirty pages of both files to disk (msync)
+    bool flush()
+    {
+        if (!base || !buckets) return false;
+        return ::msync(base, base_len, MS_SYNC) == 0
+               && ::msync(buckets, buckets_len, MS_SYNC) == 0;
+    }
+
+    /// Returns the value by key, same semantics as HashMap::get()
+    [[nodiscard]] std::optional<V> get(const K &key) const
+    {
+        if (!base || header().size == 0) return std::nullopt;
+        const uint64_t h = hasher(key);
+        const uint64_t off = Chain::find(base, buckets[h & (header().capacity - 1)], key, h);
+        if (!off) return std::nullopt;
+        return std::optional<V>(Chain::node(base, off)->value);
+    }
+
+    /**
+     * @brief Inserts or updates a key-value pair.
+     *
+     * May grow the arena or the bucket file. If the arena cannot grow the
+     * element is not inserted; if the bucket file cannot grow the element
+     * stays in the undersized table. Either way ok() turns false.
+     */
+    void put(const K &key, const V &value)
+    {
+        if (!good) return;
+        const uint64_t h = hasher(key);
+        const uint64_t found = Chain::find(base, buckets[h & (header().capacity - 1)], key, h);
+        if (found)
+        {
+            Chain::node(base, found)->value = value;
+            return;
+        }
+
+        const uint64_t off = allocateNode();
+        if (!off) return;
+        Header &hd = header();
+        const uint64_t index = h & (hd.capacity - 1);
+        NodeT *e = Chain::node(base, off);
+        e->hash = h;
+        e->next = buckets[index];
+        e->key = key;
+        e->value = value;
+        buckets[index] = off;
+
+        if (++hd.size > static_cast<uint64_t>(hd.capacity * LOAD_FACTOR) && !growBuckets())
+        {
+            good = false;
+        }
+    }
+
+    /// Removes an element by key, its node is reused by later inserts
+    bool remove(const K &key)
+    {
+        if (!good || header().size == 0) return false;
+        const uint64_t h = hasher(key);
+        Header &hd = header();
+        const uint64_t off = Chain::unlink(base, buckets[h & (hd.capacity - 1)], key, h);
+        if (!off) return false;
+        Chain::node(base, off)->next = hd.free_head;
+        hd.free_head = off;
+        --hd.size;
+        return true;
+    }
+
+    /// Removes all elements, file sizes are kept
+    void clear()
+    {
+        if (!good) return;
+        std::memset(buckets, 0, buckets_len);
+        Header &hd = header();
+        hd.size = 0;
+        hd.arena_end = ARENA_START;
+        hd.free_head = 0;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return base ? header().size : 0;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /// False after an I/O error or while closed
+    [[nodiscard]] bool ok() const
+    {
+        return good;
+    }
+};
+
+#endif //CPPHASHMAP_PERSISTENTHASHMAP_H
@@ -0,0 +1,396 @@
+#ifndef CPPHASHMAP_SERIALIZATION_H
+#define CPPHASHMAP_SERIALIZATION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file Serialization.h
+ * @brief Buffered binary streams and per-type codecs.
+ *
+ * BinaryWriter / BinaryReader wrap a FILE* with their own buffer so that
+ * many small writes (one key, one value) cost a memcpy instead of a libc
+ * call. Errors are sticky: after the first failure every further call is a
+ * no-op and ok() returns false, so callers check once at the end.
+ *
+ * ByteBuffer / ByteSpanReader offer the same interface over memory, for
+ * formats that frame or checksum records before they reach the file.
+ *
+ * Codec<T> describes how a single value is stored, for any of the streams:
+ *  - trivially copyable types are stored as raw bytes (native endianness);
+ *  - std::string is stored as a varint length followed by its bytes.
+ *
+ * Readers report remaining() bytes, so lengths and counts read from a file
+ * can be checked before anything is allocated for them.
+ */
+
+class BinaryWriter
+{
+    /// Output file, owned
+    std::FILE *file = nullptr;
+
+    /// Write buffer
+    std::vector<char> buffer;
+
+    /// Number of bytes used in buffer
+    size_t used = 0;
+
+    /// Sticky error flag
+    bool good = false;
+
+    void flushBuffer()
+    {
+        if (good && file && used != 0 && std::fwrite(buffer.data(), 1, used, file) != used)
+        {
+            good = false;
+        }
+        used = 0;
+    }
+
+public:
+    explicit BinaryWriter(const std::string &path, const size_t buffer_size = 1 << 16)
+        : file(std::fopen(path.c_str(), "wb")), buffer(buffer_size), good(file != nullptr) {}
+
+    BinaryWriter(const BinaryWriter&) = delete;
+    BinaryWriter& operator=(const BinaryWriter&) = delete;
+
+    ~BinaryWriter()
+    {
+        close();
+    }
+
+    /// Writes @p n raw bytes
+    void writeBytes(const void *data, const size_t n)
+    {
+        if (!good || !file || n == 0) return;
+        if (used + n > buffer.size())
+        {
+            flushBuffer();
+            if (n > buffer.size())
+            {
+                if (std::fwrite(data, 1, n, file) != n) good = false;
+                return;
+            }
+        }
+        std::memcpy(buffer.data() + used, data, n);
+        used += n;
+    }
+
+    /// Writes a trivially copyable value as raw bytes
+    template <typename T>
+    void writePod(const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        writeBytes(&value, sizeof(T));
+    }
+
+    /// Writes an unsigned LEB128 varint
+    void writeVarint(uint64_t value)
+    {
+        char out[10];
+        size_t n = 0;
+        while (value >= 0x80)
+        {
+            out[n++] = static_cast<char>(value | 0x80);
+            value >>= 7;
+        }
+        out[n++] = static_cast<char>(value);
+        writeBytes(out, n);
+    }
+
+    /// Pushes buffered data to the OS (does not fsync)
+    void flush()
+    {
+        flushBuffer();
+        if (good && std::fflush(file) != 0) good = false;
+    }
+
+    /// Flushes and closes the file, returns ok()
+    bool close()
+    {
+        if (!file) return good;
+        flush();
+        if (std::fclose(file) != 0) good = false;
+        file = nullptr;
+        return good;
+    }
+
+    [[nodiscard]] bool ok() const
+    {
+        return good;
+    }
+
+    /// Underlying FILE*, nullptr after close()
+    [[nodiscard]] std::FILE *handle() const
+    {
+        return file;
+    }
+};
+
+class BinaryReader
+{
+    /// Input file, owned
+    std::FILE *file = nullptr;
+
+    /// Read buffer
+    std::vector<char> buffer;
+
+    /// Read position in buffer
+    size_t pos = 0;
+
+    /// Number of valid bytes in buffer
+    size_t end = 0;
+
+    /// Sticky error flag
+    bool good = false;
+
+    /// Bytes of the file not loaded into buffer yet
+    uint64_t unread = 0;
+
+    bool refill()
+    {
+        pos = 0;
+        end = std::fread(buffer.data(), 1, buffer.size(), file);
+        unread -= std::min<uint64_t>(unread, end);
+        return end != 0;
+    }
+
+public:
+    explicit BinaryReader(const std::string &path, const size_t buffer_size = 1 << 16)
+        : file(std::fopen(path.c_str(), "rb")), buffer(buffer_size), good(file != nullptr)
+    {
+        if (file && std::fseek(file, 0, SEEK_END) == 0)
+        {
+            const long n = std::ftell(file);
+            unread = n > 0 ? static_cast<uint64_t>(n) : 0;
+            std::fseek(file, 0, SEEK_SET);
+        }
+    }
+
+    BinaryReader(const BinaryReader&) = delete;
+    BinaryReader& operator=(const BinaryReader&) = delete;
+
+    ~BinaryReader()
+    {
+        if (file) std::fclose(file);
+    }
+
+    /// Reads exactly @p n bytes, returns false on short read
+    bool readBytes(void *data, size_t n)
+    {
+        if (!good) return false;
+        char *out = static_cast<char *>(data);
+        while (n != 0)
+        {
+            if (pos == end && !refill())
+            {
+                good = false;
+                return false;
+            }
+            const size_t chunk = std::min(n, end - pos);
+            std::memcpy(out, buffer.data() + pos, chunk);
+            pos += chunk;
+            out += chunk;
+            n -= chunk;
+        }
+        return true;
+    }
+
+    /// Reads a trivially copyable value stored as raw bytes
+    template <typename T>
+    bool readPod(T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return readBytes(&value, sizeof(T));
+    }
+
+    /// Reads an unsigned LEB128 varint
+    bool readVarint(uint64_t &value)
+    {
+        value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            unsigned char byte;
+            if (!readBytes(&byte, 1)) return false;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        good = false;
+        return false;
+    }
+
+    /// Number of bytes not read yet, an upper bound for lengths read from the file
+    [[nodiscard]] uint64_t remaining() const
+    {
+        return (end - pos) + unread;
+    }
+
+    /// Checks whether the whole file has been consumed
+    [[nodiscard]] bool atEnd()
+    {
+        return good && pos == end && !refill();
+    }
+
+    [[nodiscard]] bool ok() const
+    {
+        return good;
+    }
+};
+
+class ByteBuffer
+{
+    std::vector<char> bytes;
+
+public:
+    void writeBytes(const void *data, const size_t n)
+    {
+        const char *p = static_cast<const char *>(data);
+        bytes.insert(bytes.end(), p, p + n);
+    }
+
+    template <typename T>
+    void writePod(const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        writeBytes(&value, sizeof(T));
+    }
+
+    void writeVarint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            bytes.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<char>(value));
+    }
+
+    /// Overwrites previously written bytes at @p pos
+    void patch(const size_t pos, const void *data, const size_t n)
+    {
+        std::memcpy(bytes.data() + pos, data, n);
+    }
+
+    void clear()
+    {
+        bytes.clear();
+    }
+
+    [[nodiscard]] const char *data() const
+    {
+        return bytes.data();
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return bytes.size();
+    }
+
+    [[nodiscard]] bool ok() const
+    {
+        return true;
+    }
+};
+
+class ByteSpanReader
+{
+    const char *pos;
+    const char *end;
+    bool good = true;
+
+public:
+    ByteSpanReader(const char *data, const size_t n) : pos(data), end(data + n) {}
+
+    bool readBytes(void *data, const size_t n)
+    {
+        if (!good || static_cast<size_t>(end - pos) < n)
+        {
+            good = false;
+            return false;
+        }
+        std::memcpy(data, pos, n);
+        pos += n;
+        return true;
+    }
+
+    template <typename T>
+    bool readPod(T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return readBytes(&value, sizeof(T));
+    }
+
+    bool readVarint(uint64_t &value)
+    {
+        value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            unsigned char byte;
+            if (!readBytes(&byte, 1)) return false;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        good = false;
+        return false;
+    }
+
+    /// Number of bytes not read yet
+    [[nodiscard]] size_t remaining() const
+    {
+        return end - pos;
+    }
+
+    [[nodiscard]] bool ok() const
+    {
+        return good;
+    }
+};
+
+template <typename T, typename = void>
+struct Codec;
+
+/// Raw bytes for trivially copyable types
+template <typename T>
+struct Codec<T, std::enable_if_t<std::is_trivially_copyable_v<T>>>
+{
+    template <typename Out>
+    static void write(Out &out, const T &value)
+    {
+        out.writePod(value);
+    }
+
+    template <typename In>
+    static bool read(In &in, T &value)
+    {
+        return in.readPod(value);
+    }
+};
+
+/// Varint length prefix followed by the characters
+template <>
+struct Codec<std::string>
+{
+    template <typename Out>
+    static void write(Out &out, const std::string &value)
+    {
+        out.writeVarint(value.size());
+        out.writeBytes(value.data(), value.size());
+    }
+
+    template <typename In>
+    static bool read(In &in, std::string &value)
+    {
+        uint64_t n;
+        // A corrupt length must fail the read, not the allocation
+        if (!in.readVarint(n) || n > in.remaining()) return false;
+        value.resize(n);
+        return in.readBytes(value.data(), n);
+    }
+};
+
+#endif //CPPHASHMAP_SERIALIZATION_H
@@ -0,0 +1,407 @@
+#ifndef CPPHASHMAP_SHAREDHASHMAP_H
+#define CPPHASHMAP_SHAREDHASHMAP_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional> // std::hash
+#include <optional>
+#include <string>
+#include <typeinfo>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "OffsetChain.h"
+
+/**
+ * @file SharedHashMap.h
+ * @brief Fixed-capacity hash map in POSIX shared memory.
+ *
+ * One process create()s the map in a shared memory object, any number of
+ * processes open() it and work on the same data. The region holds
+ *
+ *     header (counters, locks) | bucket array | node pool
+ *
+ * and every link is an offset from the region start (see OffsetChain.h),
+ * so each process may map it at a different address.
+ *
+ * Capacity is fixed at creation: the bucket count is chosen for the
+ * maximum number of entries at load factor 0.75 and the node pool holds
+ * exactly that many nodes. put() of a new key fails when the pool is full.
+ *
+ * Concurrency: buckets are guarded by 64 process-shared reader-writer locks
+ * (stripe = bucket index mod 64), node allocation by a process-shared
+ * mutex taken inside a stripe lock. Lookups in different stripes never
+ * contend, lookups in the same stripe share the read lock.
+ *
+ * The locks are not robust: a process that dies inside get(), put() or
+ * remove() leaves its stripe (or the pool mutex) locked, and every other
+ * process blocks on it for good. The region must then be unlinked and
+ * created again.
+ *
+ * Keys and values must be trivially copyable and every process must use
+ * the same build of K, V and std::hash. The header records a fingerprint
+ * of K and V (size, alignment and the bytes of typeid().name()), and
+ * open() refuses a region created for other types, even if their nodes
+ * have the same size.
+ */
+
+inline constexpr char SHARED_MAGIC[4] = {'H', 'M', 'S', 'H'};
+inline constexpr uint32_t SHARED_VERSION = 3;
+
+template <typename K, typename V>
+class SharedHashMap
+{
+    using Chain = OffsetChain<K, V>;
+    using NodeT = typename Chain::NodeT;
+
+    static constexpr size_t STRIPES = 64;
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                  "counters in shared memory must be lock-free");
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t node_size;
+        std::atomic<uint32_t> ready;
+        uint64_t type_tag;
+        uint64_t capacity;
+        uint64_t node_capacity;
+        uint64_t buckets_offset;
+        uint64_t nodes_offset;
+        uint64_t region_size;
+        std::atomic<uint64_t> size;
+        pthread_mutex_t alloc_lock;
+        uint64_t free_head;
+        uint64_t pool_end;
+        pthread_rwlock_t stripes[STRIPES];
+    };
+
+    /// Start of the mapping, nullptr when closed
+    char *base = nullptr;
+
+    /// Length of the mapping
+    size_t length = 0;
+
+    std::hash<K> hasher;
+
+    [[nodiscard]] Header &header() const
+    {
+        return *reinterpret_cast<Header *>(base);
+    }
+
+    [[nodiscard]] uint64_t *buckets() const
+    {
+        return reinterpret_cast<uint64_t *>(base + header().buckets_offset);
+    }
+
+    [[nodiscard]] pthread_rwlock_t &stripe(const uint64_t index) const
+    {
+        return header().stripes[index % STRIPES];
+    }
+
+    static std::string shmName(const std::string &name)
+    {
+        return name.empty() || name[0] != '/' ? "/" + name : name;
+    }
+
+    static uint64_t alignUp(const uint64_t value, const uint64_t align)
+    {
+        return (value + align - 1) / align * align;
+    }
+
+    /**
+     * @brief Fingerprint of the K/V layout and identity, stored in the header.
+     *
+     * Type names are hashed byte by byte: unlike type_info::hash_code(),
+     * which may change between runs, the name is the same in every process
+     * built with the same compiler ABI.
+     */
+    static uint64_t typeTag()
+    {
+        uint64_t tag = 14695981039346656037ull;
+        for (const uint64_t part : {uint64_t{sizeof(K)}, uint64_t{alignof(K)},
+                                    uint64_t{sizeof(V)}, uint64_t{alignof(V)}})
+        {
+            tag = (tag ^ part) * 1099511628211ull;
+        }
+        for (const char *name : {typeid(K).name(), typeid(V).name()})
+        {
+            for (; *name; ++name)
+            {
+                tag = (tag ^ static_cast<unsigned char>(*name)) * 1099511628211ull;
+            }
+            // Separator, so that names split differently do not collide
+            tag = (tag ^ 0xff) * 1099511628211ull;
+        }
+        return tag;
+    }
+
+    /// Takes a node from the pool, 0 if full. Caller holds a stripe lock.
+    uint64_t allocateNode()
+    {
+        Header &h = header();
+        pthread_mutex_lock(&h.alloc_lock);
+        uint64_t off = 0;
+        if (h.free_head)
+        {
+            off = h.free_head;
+            h.free_head = Chain::node(base, off)->next;
+        }
+        else if (h.pool_end < h.region_size)
+        {
+            off = h.pool_end;
+            h.pool_end += sizeof(NodeT);
+        }
+        pthread_mutex_unlock(&h.alloc_lock);
+        return off;
+    }
+
+    void freeNode(const uint64_t off)
+    {
+        Header &h = header();
+        pthread_mutex_lock(&h.alloc_lock);
+        Chain::node(base, off)->next = h.free_head;
+        h.free_head = off;
+        pthread_mutex_unlock(&h.alloc_lock);
+    }
+
+    bool map(const int fd, const size_t len)
+    {
+        void *mem = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mem == MAP_FAILED) return false;
+        base = static_cast<char *>(mem);
+        length = len;
+        return true;
+    }
+
+    /// RAII guard for a stripe lock
+    class StripeLock
+    {
+        pthread_rwlock_t &lock;
+
+    public:
+        StripeLock(pthread_rwlock_t &l, const bool write) : lock(l)
+        {
+            if (write) pthread_rwlock_wrlock(&lock);
+            else pthread_rwlock_rdlock(&lock);
+        }
+
+        ~StripeLock()
+        {
+            pthread_rwlock_unlock(&lock);
+        }
+
+        StripeLock(const StripeLock&) = delete;
+        StripeLock& operator=(const StripeLock&) = delete;
+    };
+
+public:
+    SharedHashMap() = default;
+
+    SharedHashMap(const SharedHashMap&) = delete;
+    SharedHashMap& operator=(const SharedHashMap&) = delete;
+
+    ~SharedHashMap()
+    {
+        close();
+    }
+
+    /**
+     * @brief Creates a new shared memory object @p name sized for @p max_entries.
+     *
+     * Fails if the object already exists. Other processes can open() it as
+     * soon as this returns.
+     */
+    bool create(const std::string &name, const size_t max_entries)
+    {
+        close();
+        const std::string shm = shmName(name);
+        const int fd = ::shm_open(shm.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) return false;
+
+        uint64_t cap = 16;
+        while (static_cast<double>(cap) * 0.75 < static_cast<double>(max_entries))
+        {
+            cap *= 2;
+        }
+        const uint64_t buckets_offset = alignUp(sizeof(Header), alignof(uint64_t));
+        const uint64_t nodes_offset = alignUp(buckets_offset + cap * sizeof(uint64_t), alignof(NodeT));
+        const uint64_t region_size = nodes_offset + (max_entries ? max_entries : 1) * sizeof(NodeT);
+
+        if (::ftruncate(fd, static_cast<off_t>(region_size)) != 0 || !map(fd, region_size))
+        {
+            ::close(fd);
+            ::shm_unlink(shm.c_str());
+            return false;
+        }
+        ::close(fd);
+
+        // ftruncate zero-fills: buckets are empty, ready is 0
+        Header &h = header();
+        std::memcpy(h.magic, SHARED_MAGIC, sizeof(SHARED_MAGIC));
+        h.version = SHARED_VERSION;
+        h.node_size = sizeof(NodeT);
+        h.type_tag = typeTag();
+        h.capacity = cap;
+        h.node_capacity = max_entries ? max_entries : 1;
+        h.buckets_offset = buckets_offset;
+        h.nodes_offset = nodes_offset;
+        h.region_size = region_size;
+        h.size.store(0, std::memory_order_relaxed);
+        h.free_head = 0;
+        h.pool_end = nodes_offset;
+
+        pthread_mutexattr_t mattr;
+        pthread_mutexattr_init(&mattr);
+        pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED);
+        pthread_mutex_init(&h.alloc_lock, &mattr);
+        pthread_mutexattr_destroy(&mattr);
+
+        pthread_rwlockattr_t rwattr;
+        pthread_rwlockattr_init(&rwattr);
+        pthread_rwlockattr_setpshared(&rwattr, PTHREAD_PROCESS_SHARED);
+        for (pthread_rwlock_t &lock : h.stripes)
+        {
+            pthread_rwlock_init(&lock, &rwattr);
+        }
+        pthread_rwlockattr_destroy(&rwattr);
+
+        h.ready.store(1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Opens a map created by another (or this) process.
+     *
+     * @return false if the object does not exist, is not initialized yet or
+     *         was created for other K/V types
+     */
+    bool open(const std::string &name)
+    {
+        close();
+        const int fd = ::shm_open(shmName(name).c_str(), O_RDWR, 0600);
+        if (fd < 0) return false;
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)
+            || !map(fd, static_cast<size_t>(st.st_size)))
+        {
+            ::close(fd);
+            return false;
+        }
+        ::close(fd);
+
+        const Header &h = header();
+        if (h.ready.load(std::memory_order_acquire) != 1
+            || std::memcmp(h.magic, SHARED_MAGIC, sizeof(SHARED_MAGIC)) != 0
+            || h.version != SHARED_VERSION
+            || h.node_size != sizeof(NodeT)
+            || h.type_tag != typeTag()
+            || h.region_size != length)
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /// Unmaps the region, the shared object itself stays until unlink()
+    void close()
+    {
+        if (base) ::munmap(base, length);
+        base = nullptr;
+        length = 0;
+    }
+
+    /// Removes the shared memory object @p name (mapped views stay valid)
+    static bool unlink(const std::string &name)
+    {
+        return ::shm_unlink(shmName(name).c_str()) == 0;
+    }
+
+    /// Returns the value by key, same semantics as HashMap::get()
+    [[nodiscard]] std::optional<V> get(const K &key) const
+    {
+        if (!base) return std::nullopt;
+        const uint64_t h = hasher(key);
+        const uint64_t index = h & (header().capacity - 1);
+        StripeLock lock(stripe(index), false);
+        const uint64_t off = Chain::find(base, buckets()[index], key, h);
+        if (!off) return std::nullopt;
+        return std::optional<V>(Chain::node(base, off)->value);
+    }
+
+    /**
+     * @brief Inserts or updates a key-value pair.
+     *
+     * @return false if the key is new and the node pool is full
+     */
+    bool put(const K &key, const V &value)
+    {
+        if (!base) return false;
+        const uint64_t h = hasher(key);
+        const uint64_t index = h & (header().capacity - 1);
+        StripeLock lock(stripe(index), true);
+        uint64_t &head = buckets()[index];
+        const uint64_t found = Chain::find(base, head, key, h);
+        if (found)
+        {
+            Chain::node(base, found)->value = value;
+            return true;
+        }
+        const uint64_t off = allocateNode();
+        if (!off) return false;
+        NodeT *e = Chain::node(base, off);
+        e->hash = h;
+        e->next = head;
+        e->key = key;
+        e->value = value;
+        head = off;
+        header().size.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// Removes an element by key, its node returns to the pool
+    bool remove(const K &key)
+    {
+        if (!base) return false;
+        const uint64_t h = hasher(key);
+        const uint64_t index = h & (header().capacity - 1);
+        StripeLock lock(stripe(index), true);
+        const uint64_t off = Chain::unlink(base, buckets()[index], key, h);
+        if (!off) return false;
+        freeNode(off);
+        header().size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// Number of elements, may be stale while other processes write
+    [[nodiscard]] size_t size() const
+    {
+        return base ? header().size.load(std::memory_order_relaxed) : 0;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /// Maximum number of elements fixed at creation
+    [[nodiscard]] size_t maxSize() const
+    {
+        return base ? header().node_capacity : 0;
+    }
+
+    [[nodiscard]] bool isOpen() const
+    {
+        return base != nullptr;
+    }
+};
+
+#endif //CPPHASHMAP_SHAREDHASHMAP_H
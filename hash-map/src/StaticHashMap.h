@@ -0,0 +1,245 @@
+#ifndef CPPHASHMAP_STATICHASHMAP_H
+#define CPPHASHMAP_STATICHASHMAP_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @file StaticHashMap.h
+ * @brief Immutable hash map built at compile time with a perfect hash.
+ *
+ *     constexpr auto OPCODES = makeStaticHashMap<std::string_view, int>({
+ *         {"add", 1}, {"sub", 2}, {"mul", 3},
+ *     });
+ *     static_assert(OPCODES.get("sub") == 2);
+ *
+ * Declared constexpr, the tables are computed by the compiler and the map
+ * is plain data in .rodata: no startup cost, no heap.
+ *
+ * Perfect hashing (hash and displace): keys are first split into buckets
+ * by their hash, then buckets are placed largest first, each searching for
+ * a seed that sends all of its keys to distinct free slots. A lookup is one
+ * key hash, two integer mixes and a single probe with one key compare.
+ *
+ * Keys must be integers, enums or std::string_view; keys and values must
+ * be usable in constant expressions (literal, default constructible).
+ * Duplicate keys (or distinct keys with equal hashes) are detected before
+ * the seed search: a compile error at the throw in the constructor when
+ * the map is constexpr, a StaticHashMapError when it is built at run time.
+ */
+
+/// Thrown by a StaticHashMap built at run time from keys it cannot separate
+class StaticHashMapError : public std::logic_error
+{
+public:
+    using std::logic_error::logic_error;
+};
+
+namespace static_hash_map_detail
+{
+    /// splitmix64 finalizer
+    constexpr uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        x ^= x >> 31;
+        return x;
+    }
+
+    /// constexpr key hash: the value itself for integers, FNV-1a for strings
+    template <typename K>
+    constexpr uint64_t hashKey(const K &key)
+    {
+        if constexpr (std::is_convertible_v<const K &, std::string_view>)
+        {
+            uint64_t h = 14695981039346656037ull;
+            for (const char c : std::string_view(key))
+            {
+                h ^= static_cast<unsigned char>(c);
+                h *= 1099511628211ull;
+            }
+            return h;
+        }
+        else
+        {
+            static_assert(std::is_integral_v<K> || std::is_enum_v<K>,
+                          "StaticHashMap keys must be integers, enums or strings");
+            return static_cast<uint64_t>(key);
+        }
+    }
+
+    /// Slot count: a power of two, at most 80% full
+    constexpr size_t tableSize(const size_t n)
+    {
+        size_t m = std::bit_ceil(n < 1 ? size_t{1} : n);
+        if (m < n + n / 4) m *= 2;
+        return m;
+    }
+
+    /// Bucket count: about 3 keys per bucket
+    constexpr size_t bucketCount(const size_t n)
+    {
+        return std::max<size_t>(1, tableSize(n) / 4);
+    }
+}
+
+template <typename K, typename V, size_t N>
+class StaticHashMap
+{
+    static constexpr size_t SLOTS = static_hash_map_detail::tableSize(N);
+    static constexpr size_t BUCKETS = static_hash_map_detail::bucketCount(N);
+
+    /// Seeds tried per bucket before giving up
+    static constexpr uint32_t MAX_SEED = 1u << 20;
+
+    /// Displacement seed per bucket
+    std::array<uint32_t, BUCKETS> seeds{};
+
+    std::array<K, SLOTS> keys{};
+    std::array<V, SLOTS> values{};
+    std::array<bool, SLOTS> used{};
+
+    static constexpr size_t bucketOf(const uint64_t h)
+    {
+        return static_hash_map_detail::mix(h) & (BUCKETS - 1);
+    }
+
+    static constexpr size_t slotOf(const uint64_t h, const uint32_t seed)
+    {
+        return static_hash_map_detail::mix(h ^ (static_cast<uint64_t>(seed) + 1) * 0x9e3779b97f4a7c15ull)
+               & (SLOTS - 1);
+    }
+
+public:
+    /**
+     * @brief Builds the tables for @p entries.
+     *
+     * Usually evaluated by the compiler (see makeStaticHashMap()); at run
+     * time the cost is O(n) expected.
+     */
+    constexpr explicit StaticHashMap(const std::array<std::pair<K, V>, N> &entries)
+    {
+        std::array<uint64_t, N> hashes{};
+        std::array<size_t, BUCKETS> bucket_size{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            hashes[i] = static_hash_map_detail::hashKey(entries[i].first);
+            ++bucket_size[bucketOf(hashes[i])];
+        }
+
+        // Equal hashes collide for every seed: fail now, not after MAX_SEED tries
+        std::array<uint64_t, N> sorted = hashes;
+        std::sort(sorted.begin(), sorted.end());
+        if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+        {
+            throw StaticHashMapError("StaticHashMap: duplicate key or equal key hashes");
+        }
+
+        // Entry indices grouped by bucket (counting sort)
+        std::array<size_t, BUCKETS + 1> start{};
+        for (size_t b = 0; b < BUCKETS; ++b) start[b + 1] = start[b] + bucket_size[b];
+        std::array<size_t, N> members{};
+        std::array<size_t, BUCKETS> filled{};
+        for (size_t i = 0; i < N; ++i)
+        {
+            const size_t b = bucketOf(hashes[i]);
+            members[start[b] + filled[b]++] = i;
+        }
+
+        // Buckets in descending size order (counting sort by size)
+        size_t largest = 0;
+        for (const size_t sz : bucket_size) largest = std::max(largest, sz);
+        std::array<size_t, BUCKETS> order{};
+        size_t placed = 0;
+        for (size_t sz = largest; sz > 0; --sz)
+        {
+            for (size_t b = 0; b < BUCKETS; ++b)
+            {
+                if (bucket_size[b] == sz) order[placed++] = b;
+            }
+        }
+
+        std::array<size_t, N> slots{};
+        for (size_t o = 0; o < placed; ++o)
+        {
+            const size_t b = order[o];
+            const size_t first = start[b];
+            const size_t count = bucket_size[b];
+            uint32_t seed = 0;
+            for (;; ++seed)
+            {
+                if (seed == MAX_SEED) throw StaticHashMapError("StaticHashMap: no perfect hash found");
+                bool fits = true;
+                for (size_t k = 0; k < count && fits; ++k)
+                {
+                    const size_t s = slotOf(hashes[members[first + k]], seed);
+                    fits = !used[s];
+                    for (size_t j = 0; j < k && fits; ++j) fits = slots[j] != s;
+                    slots[k] = s;
+                }
+                if (fits) break;
+            }
+            seeds[b] = seed;
+            for (size_t k = 0; k < count; ++k)
+            {
+                const std::pair<K, V> &entry = entries[members[first + k]];
+                used[slots[k]] = true;
+                keys[slots[k]] = entry.first;
+                values[slots[k]] = entry.second;
+            }
+        }
+    }
+
+    /// Same semantics as HashMap::get()
+    [[nodiscard]] constexpr std::optional<V> get(const K &key) const
+    {
+        const uint64_t h = static_hash_map_detail::hashKey(key);
+        const size_t s = slotOf(h, seeds[bucketOf(h)]);
+        if (!used[s] || !(keys[s] == key)) return std::nullopt;
+        return std::optional<V>(values[s]);
+    }
+
+    [[nodiscard]] constexpr size_t size() const
+    {
+        return N;
+    }
+
+    [[nodiscard]] constexpr bool empty() const
+    {
+        return N == 0;
+    }
+
+    /// Calls fn(key, value) for every element, in unspecified order
+    template <typename F>
+    constexpr void forEach(F &&fn) const
+    {
+        for (size_t s = 0; s < SLOTS; ++s)
+        {
+            if (used[s]) fn(keys[s], values[s]);
+        }
+    }
+};
+
+/**
+ * @brief Builds a StaticHashMap from a braced list of pairs.
+ *
+ * Declare the result constexpr to build it at compile time.
+ */
+template <typename K, typename V, size_t N>
+constexpr StaticHashMap<K, V, N> makeStaticHashMap(const std::pair<K, V> (&entries)[N])
+{
+    std::array<std::pair<K, V>, N> list{};
+    for (size_t i = 0; i < N; ++i) list[i] = entries[i];
+    return StaticHashMap<K, V, N>(list);
+}
+
+#endif //CPPHASHMAP_STATICHASHMAP_H
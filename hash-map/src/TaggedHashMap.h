@@ -0,0 +1,283 @@
+#ifndef CPPHASHMAP_TAGGEDHASHMAP_H
+#define CPPHASHMAP_TAGGEDHASHMAP_H
+
+#include <cstdint>
+#include <functional> // std::hash
+#include <optional>
+#include <utility>
+
+/**
+ * @file TaggedHashMap.h
+ * @brief Chained hash map with chain summaries packed into link pointers.
+ *
+ * Same structure as HashMap (bucket array + singly linked nodes), but every
+ * link, bucket slots and next pointers alike, is a 64-bit word:
+ *
+ *     | 16-bit summary | 48-bit node address |
+ *
+ * x86-64 and AArch64 user space addresses fit in 48 bits, the top 16 bits
+ * are free. Each node hash selects one of 16 fingerprint bits (from the
+ * high bits of the mixed hash), and a link's summary is the OR of the
+ * fingerprint bits of every node from the one it points to up to the end
+ * of the chain — a 16-bit Bloom filter of the rest of the chain.
+ *
+ * get() checks its fingerprint bit in the link before dereferencing it,
+ * so a lookup of a missing key usually stops at the bucket slot without
+ * touching any node, and a walk stops as soon as no remaining node can
+ * match. With chains of 1-2 nodes the filter rejects about 90% of misses.
+ *
+ * remove() recomputes the summaries of the links in front of the removed
+ * node in a second walk over the same prefix, so summaries stay exact under
+ * insert/remove churn and the filter does not decay between resizes.
+ */
+
+template <typename K, typename V>
+class TaggedHashMap
+{
+    static_assert(sizeof(uintptr_t) == 8, "tagged links need 64-bit pointers");
+
+    struct TaggedNode
+    {
+        const K key;
+        V value;
+        const size_t hash;
+
+        /// Tagged link to the next node
+        uintptr_t next;
+    };
+
+    static constexpr unsigned TAG_SHIFT = 48;
+    static constexpr uintptr_t ADDRESS_MASK = (uintptr_t{1} << TAG_SHIFT) - 1;
+
+    /// Tagged links, nullptr until the first put()
+    uintptr_t *buckets = nullptr;
+
+    size_t sz = 0;
+    size_t capacity = 16;
+    float load_factor = 0.75f;
+    size_t threshold = static_cast<size_t>(capacity * load_factor);
+
+    std::hash<K> hasher;
+
+    /// Number of the fingerprint bit of a hash, 0-15
+    static unsigned fingerprintIndex(const size_t h)
+    {
+        const uint64_t mixed = static_cast<uint64_t>(h) * 0x9e3779b97f4a7c15ull;
+        return static_cast<unsigned>(mixed >> 60);
+    }
+
+    /// Fingerprint bit of a hash, already shifted into the tag position
+    static uintptr_t fingerprint(const size_t h)
+    {
+        return uintptr_t{1} << (TAG_SHIFT + fingerprintIndex(h));
+    }
+
+    static TaggedNode *node(const uintptr_t link)
+    {
+        return reinterpret_cast<TaggedNode *>(link & ADDRESS_MASK);
+    }
+
+    /// Link to @p e in front of @p rest, summary = e's bit + rest's summary
+    static uintptr_t makeLink(TaggedNode *e, const uintptr_t rest)
+    {
+        return reinterpret_cast<uintptr_t>(e) | fingerprint(e->hash) | (rest & ~ADDRESS_MASK);
+    }
+
+    void init(const size_t cap)
+    {
+        capacity = cap;
+        threshold = static_cast<size_t>(capacity * load_factor);
+        buckets = new uintptr_t[capacity]();
+    }
+
+    /// Doubles the bucket array and relinks every node with fresh summaries
+    void resize()
+    {
+        uintptr_t *old = buckets;
+        const size_t old_cap = capacity;
+        init(capacity * 2);
+        for (size_t i = 0; i < old_cap; ++i)
+        {
+            uintptr_t link = old[i];
+            while (link)
+            {
+                TaggedNode *e = node(link);
+                link = e->next;
+                uintptr_t &head = buckets[e->hash & (capacity - 1)];
+                e->next = head;
+                head = makeLink(e, head);
+            }
+        }
+        delete[] old;
+    }
+
+    /// Returns the node holding @p key, or nullptr
+    [[nodiscard]] TaggedNode *find(const K &key, const size_t h) const
+    {
+        const uintptr_t bit = fingerprint(h);
+        uintptr_t link = buckets[h & (capacity - 1)];
+        while (link & bit)
+        {
+            TaggedNode *e = node(link);
+            if (e->hash == h && e->key == key) return e;
+            link = e->next;
+        }
+        return nullptr;
+    }
+
+public:
+    TaggedHashMap() = default;
+
+    TaggedHashMap(const TaggedHashMap&) = delete;
+    TaggedHashMap& operator=(const TaggedHashMap&) = delete;
+
+    TaggedHashMap(TaggedHashMap &&other) noexcept
+        : buckets(std::exchange(other.buckets, nullptr)),
+          sz(std::exchange(other.sz, 0)),
+          capacity(std::exchange(other.capacity, 16)),
+          load_factor(other.load_factor),
+          threshold(std::exchange(other.threshold, static_cast<size_t>(16 * other.load_factor))) {}
+
+    TaggedHashMap& operator=(TaggedHashMap &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            buckets = std::exchange(other.buckets, nullptr);
+            sz = std::exchange(other.sz, 0);
+            capacity = std::exchange(other.capacity, 16);
+            load_factor = other.load_factor;
+            threshold = std::exchange(other.threshold, static_cast<size_t>(16 * other.load_factor));
+        }
+        return *this;
+    }
+
+    ~TaggedHashMap()
+    {
+        reset();
+    }
+
+    /// Same semantics as HashMap::get()
+    [[nodiscard]] std::optional<V> get(const K &key) const
+    {
+        if (sz == 0) return std::nullopt;
+        const TaggedNode *e = find(key, hasher(key));
+        if (!e) return std::nullopt;
+        return std::optional<V>(e->value);
+    }
+
+    /// Same semantics as HashMap::put()
+    void put(const K &key, const V &value)
+    {
+        const size_t h = hasher(key);
+        if (!buckets) init(capacity);
+        if (TaggedNode *e = find(key, h))
+        {
+            e->value = value;
+            return;
+        }
+        uintptr_t &head = buckets[h & (capacity - 1)];
+        TaggedNode *e = new TaggedNode{key, value, h, head};
+        head = makeLink(e, head);
+        if (++sz > threshold)
+        {
+            resize();
+        }
+    }
+
+    /// Removes an element by key, the summaries in front of it are recomputed
+    bool remove(const K &key)
+    {
+        if (sz == 0) return false;
+        const size_t h = hasher(key);
+        const uintptr_t bit = fingerprint(h);
+        uintptr_t *const head = &buckets[h & (capacity - 1)];
+
+        // Position of the last node in front of the match that sets each bit
+        size_t last[16];
+        uintptr_t seen = 0;
+        size_t pos = 0;
+        for (uintptr_t *link = head; *link & bit; link = &node(*link)->next, ++pos)
+        {
+            TaggedNode *e = node(*link);
+            if (!(e->hash == h && e->key == key))
+            {
+                last[fingerprintIndex(e->hash)] = pos;
+                seen |= fingerprint(e->hash);
+                continue;
+            }
+            // e->next already summarizes exactly the nodes behind e
+            const uintptr_t rest = e->next & ~ADDRESS_MASK;
+            *link = e->next;
+            delete e;
+            --sz;
+
+            // The link to node j covers the bits set by nodes j..pos-1 and the rest
+            uintptr_t *l = head;
+            for (size_t j = 0; j < pos; ++j)
+            {
+                *l = (*l & ADDRESS_MASK) | seen | rest;
+                TaggedNode *p = node(*l);
+                if (last[fingerprintIndex(p->hash)] == j) seen &= ~fingerprint(p->hash);
+                l = &p->next;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /// Removes all elements, keeps the bucket array
+    void clear()
+    {
+        if (!buckets || sz == 0) return;
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            uintptr_t link = buckets[i];
+            while (link)
+            {
+                TaggedNode *e = node(link);
+                link = e->next;
+                delete e;
+            }
+            buckets[i] = 0;
+        }
+        sz = 0;
+    }
+
+    /// Removes all elements and frees the bucket array
+    void reset()
+    {
+        clear();
+        delete[] buckets;
+        buckets = nullptr;
+        capacity = 16;
+        threshold = static_cast<size_t>(capacity * load_factor);
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return sz;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return sz == 0;
+    }
+
+    /// Calls fn(key, value) for every element, in unspecified order
+    template <typename F>
+    void forEach(F &&fn) const
+    {
+        if (!buckets) return;
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            for (uintptr_t link = buckets[i]; link; link = node(link)->next)
+            {
+                const TaggedNode *e = node(link);
+                fn(e->key, e->value);
+            }
+        }
+    }
+};
+
+#endif //CPPHASHMAP_TAGGEDHASHMAP_H
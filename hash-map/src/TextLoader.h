@@ -0,0 +1,204 @@
+#ifndef CPPHASHMAP_TEXTLOADER_H
+#define CPPHASHMAP_TEXTLOADER_H
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "HashMap.h"
+
+/**
+ * @file TextLoader.h
+ * @brief Parallel bulk loading of `key<TAB>value` text files into a HashMap.
+ *
+ * The input is memory-mapped and split into one chunk per thread at line
+ * boundaries. Loading runs in three parallel phases:
+ *
+ *  1. parse — every thread parses its chunk and creates one node per line,
+ *     hashing each key exactly once;
+ *  2. scatter — once the total is known the table is allocated, and every
+ *     thread splits its nodes into partitions by the high bits of their
+ *     bucket index, taken from the cached Node::hash;
+ *  3. merge — each partition owns a contiguous range of buckets, so
+ *     partitions are linked into the table concurrently without locks.
+ *     Nodes are merged in file order, a later duplicate key overwrites an
+ *     earlier one just as with sequential put() calls.
+ *
+ * No key is hashed twice and the table is never resized.
+ *
+ * Line format: the key ends at the first delimiter, the value at the end of
+ * the line ("\r\n" is accepted). Empty lines and lines without a delimiter
+ * are skipped.
+ */
+
+namespace text_loader_detail
+{
+    /// Returns the position right after the next '\n' at or after @p pos
+    inline size_t nextLine(const char *data, const size_t size, const size_t pos)
+    {
+        if (pos == 0 || pos >= size) return std::min(pos, size);
+        const void *nl = std::memchr(data + pos - 1, '\n', size - pos + 1);
+        return nl ? static_cast<const char *>(nl) - data + 1 : size;
+    }
+
+    /// Runs fn(i) for i in [0, count) on count threads
+    template <typename F>
+    void parallelFor(const size_t count, F &&fn)
+    {
+        std::vector<std::thread> workers;
+        workers.reserve(count);
+        for (size_t i = 1; i < count; ++i)
+        {
+            workers.emplace_back(fn, i);
+        }
+        fn(0);
+        for (std::thread &w : workers)
+        {
+            w.join();
+        }
+    }
+}
+
+/**
+ * @brief Replaces the contents of @p map with the entries of a text file.
+ *
+ * @param path input file with one `key<delimiter>value` pair per line
+ * @param map destination, emptied first
+ * @param threads number of worker threads (0 = hardware concurrency)
+ * @param delimiter separator between key and value
+ * @return false if the file cannot be opened or mapped (map is left empty)
+ *
+ * @note Complexity is O(n) work spread over @p threads threads.
+ */
+template <size_t N>
+bool loadDelimited(const std::string &path,
+                   HashMap<std::string, std::string, N> &map,
+                   size_t threads = 0,
+                   const char delimiter = '\t')
+{
+    using NodeT = Node<std::string, std::string>;
+    using Internals = HashMapInternals<std::string, std::string, N>;
+    using namespace text_loader_detail;
+
+    map.reset();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+    if (size == 0)
+    {
+        ::close(fd);
+        return true;
+    }
+    void *mem = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) return false;
+    madvise(mem, size, MADV_SEQUENTIAL);
+    const char *data = static_cast<const char *>(mem);
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max<size_t>(1, std::min(threads, size / 4096 + 1));
+
+    // Phase 1: parse chunks into per-thread node lists, in file order
+    std::vector<std::vector<NodeT *>> parsed(threads);
+    const std::hash<std::string> hasher;
+    parallelFor(threads, [&](const size_t t)
+    {
+        size_t pos = nextLine(data, size, size * t / threads);
+        const size_t end = nextLine(data, size, size * (t + 1) / threads);
+        while (pos < end)
+        {
+            const void *nl = std::memchr(data + pos, '\n', end - pos);
+            const size_t line_end = nl ? static_cast<const char *>(nl) - data : end;
+            size_t value_end = line_end;
+            if (value_end > pos && data[value_end - 1] == '\r') --value_end;
+
+            const void *delim = std::memchr(data + pos, delimiter, value_end - pos);
+            if (delim)
+            {
+                const size_t key_end = static_cast<const char *>(delim) - data;
+                std::string key(data + pos, key_end - pos);
+                std::string value(data + key_end + 1, value_end - key_end - 1);
+                const size_t h = hasher(key);
+                parsed[t].push_back(new NodeT(std::move(key), std::move(value), h));
+            }
+            pos = line_end + 1;
+        }
+    });
+    munmap(mem, size);
+
+    size_t total = 0;
+    for (const auto &nodes : parsed) total += nodes.size();
+    NodeT **buckets = Internals::prepare(map, total);
+    const size_t capacity = Internals::capacity(map);
+
+    // Partitions own contiguous bucket ranges: the high bits of the index
+    size_t bucket_bits = 0;
+    while ((size_t{1} << bucket_bits) < capacity) ++bucket_bits;
+    size_t partition_bits = 0;
+    while ((size_t{1} << partition_bits) < threads && partition_bits < bucket_bits) ++partition_bits;
+    const size_t partitions = size_t{1} << partition_bits;
+    const size_t partition_shift = bucket_bits - partition_bits;
+
+    // Phase 2: scatter each thread's nodes into partitions
+    std::vector<std::vector<std::vector<NodeT *>>> scattered(threads);
+    parallelFor(threads, [&](const size_t t)
+    {
+        scattered[t].resize(partitions);
+        for (NodeT *e : parsed[t])
+        {
+            const size_t index = e->hash & (capacity - 1);
+            scattered[t][index >> partition_shift].push_back(e);
+        }
+        std::vector<NodeT *>().swap(parsed[t]);
+    });
+
+    // Phase 3: link every partition into its own bucket range
+    std::vector<size_t> inserted(partitions, 0);
+    parallelFor(threads, [&](const size_t worker)
+    {
+        for (size_t p = worker; p < partitions; p += threads)
+        {
+            for (size_t t = 0; t < threads; ++t)
+            {
+                for (NodeT *e : scattered[t][p])
+                {
+                    const size_t index = e->hash & (capacity - 1);
+                    NodeT *existing = buckets[index];
+                    while (existing && !(existing->hash == e->hash && existing->key == e->key))
+                    {
+                        existing = existing->next;
+                    }
+                    if (existing)
+                    {
+                        existing->value = std::move(e->value);
+                        delete e;
+                        continue;
+                    }
+                    e->next = buckets[index];
+                    buckets[index] = e;
+                    ++inserted[p];
+                }
+            }
+        }
+    });
+
+    size_t count = 0;
+    for (const size_t n : inserted) count += n;
+    Internals::setSize(map, count);
+    return true;
+}
+
+#endif //CPPHASHMAP_TEXTLOADER_H
@@ -0,0 +1,221 @@
+#ifndef CPPHASHMAP_TRACE_H
+#define CPPHASHMAP_TRACE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "HashMap.h"
+#include "Serialization.h"
+
+/**
+ * @file Trace.h
+ * @brief Recording of HashMap operation sequences.
+ *
+ * Binary trace layout:
+ *
+ *     header:  "HMTR" | uint32 version
+ *     records: uint8 op | key | value (put only)
+ *
+ * Keys and values are encoded with Codec<T> (see Serialization.h), so a
+ * record of HashMap<int, int> is 9 bytes for put and 5 bytes for get/remove,
+ * clear is a single byte. The trace does not store K and V types, reader
+ * and writer must agree on them.
+ */
+
+enum class TraceOp : uint8_t
+{
+    Put = 0,
+    Get = 1,
+    Remove = 2,
+    Clear = 3
+};
+
+inline constexpr char TRACE_MAGIC[4] = {'H', 'M', 'T', 'R'};
+inline constexpr uint32_t TRACE_VERSION = 1;
+
+/// One decoded operation. Requires default constructible K and V.
+template <typename K, typename V>
+struct TraceRecord
+{
+    TraceOp op = TraceOp::Clear;
+    K key{};
+    V value{};
+};
+
+template <typename K, typename V>
+class TraceWriter
+{
+    BinaryWriter out;
+
+public:
+    /// Creates (truncates) @p path and writes the header
+    explicit TraceWriter(const std::string &path) : out(path)
+    {
+        out.writeBytes(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        out.writePod(TRACE_VERSION);
+    }
+
+    void put(const K &key, const V &value)
+    {
+        out.writePod(TraceOp::Put);
+        Codec<K>::write(out, key);
+        Codec<V>::write(out, value);
+    }
+
+    void get(const K &key)
+    {
+        out.writePod(TraceOp::Get);
+        Codec<K>::write(out, key);
+    }
+
+    void remove(const K &key)
+    {
+        out.writePod(TraceOp::Remove);
+        Codec<K>::write(out, key);
+    }
+
+    void clear()
+    {
+        out.writePod(TraceOp::Clear);
+    }
+
+    /// Flushes and closes the trace, returns false if any write failed
+    bool close()
+    {
+        return out.close();
+    }
+
+    [[nodiscard]] bool ok() const
+    {
+        return out.ok();
+    }
+};
+
+template <typename K, typename V>
+class TraceReader
+{
+    BinaryReader in;
+
+    /// Header was present and of a supported version
+    bool valid = false;
+
+public:
+    explicit TraceReader(const std::string &path) : in(path)
+    {
+        char magic[sizeof(TRACE_MAGIC)];
+        uint32_t version = 0;
+        valid = in.readBytes(magic, sizeof(magic))
+                && std::equal(magic, magic + sizeof(magic), TRACE_MAGIC)
+                && in.readPod(version)
+                && version == TRACE_VERSION;
+    }
+
+    /**
+     * @brief Decodes the next record.
+     *
+     * @return false at the end of the trace or on a malformed record;
+     *         ok() tells the two apart.
+     */
+    bool next(TraceRecord<K, V> &record)
+    {
+        if (!valid || in.atEnd()) return false;
+        if (!in.readPod(record.op)) return false;
+        switch (record.op)
+        {
+            case TraceOp::Put:
+                return Codec<K>::read(in, record.key) && Codec<V>::read(in, record.value);
+            case TraceOp::Get:
+            case TraceOp::Remove:
+                return Codec<K>::read(in, record.key);
+            case TraceOp::Clear:
+                return true;
+        }
+        valid = false;
+        return false;
+    }
+
+    /// Decodes the whole remaining trace into memory
+    std::vector<TraceRecord<K, V>> readAll()
+    {
+        std::vector<TraceRecord<K, V>> records;
+        TraceRecord<K, V> record;
+        while (next(record))
+        {
+            records.push_back(record);
+        }
+        return records;
+    }
+
+    /// False if the header was invalid or a record was truncated/malformed
+    [[nodiscard]] bool ok() const
+    {
+        return valid && in.ok();
+    }
+};
+
+/**
+ * @brief HashMap that records every operation into a trace file.
+ *
+ * Forwards put/get/remove/clear to the wrapped map and appends one record
+ * per call. Writes are buffered, the overhead per operation is a few
+ * memcpy of the encoded key and value.
+ */
+template <typename K, typename V>
+class RecordingHashMap
+{
+    HashMap<K, V> map;
+    TraceWriter<K, V> trace;
+
+public:
+    explicit RecordingHashMap(const std::string &path) : trace(path) {}
+
+    [[nodiscard]] std::optional<V> get(const K &key)
+    {
+        trace.get(key);
+        return map.get(key);
+    }
+
+    void put(const K &key, const V &value)
+    {
+        trace.put(key, value);
+        map.put(key, value);
+    }
+
+    bool remove(const K &key)
+    {
+        trace.remove(key);
+        return map.remove(key);
+    }
+
+    void clear()
+    {
+        trace.clear();
+        map.clear();
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return map.size();
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return map.empty();
+    }
+
+    /// Flushes and closes the trace, the map stays usable but unrecorded
+    bool closeTrace()
+    {
+        return trace.close();
+    }
+
+    /// Returns the wrapped map
+    [[nodiscard]] const HashMap<K, V> &getMap() const
+    {
+        return map;
+    }
+};
+
+#endif //CPPHASHMAP_TRACE_H
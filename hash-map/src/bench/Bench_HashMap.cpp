@@ -0,0 +1,451 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "CachedHashMap.h"
+#include "ColumnarHashMap.h"
+#include "CompressedSnapshot.h"
+#include "ContiguousHashMap.h"
+#include "FilteredHashMap.h"
+#include "FrozenHashMap.h"
+#include "GroupHashMap.h"
+#include "HashMap.h"
+#include "IntHashMap.h"
+#include "TaggedHashMap.h"
+
+/**
+ * Benchmarks for HashMap.
+ *
+ * Usage: bench_hashmap [--perf] [n]
+ *     --perf  additionally capture hardware counters per operation
+ *     n       number of keys (default 1000000)
+ */
+
+namespace
+{
+    /// Keeps the optimizer from discarding lookup results
+    volatile size_t sink = 0;
+
+    /// @p count draws from [0, n) with P(k) proportional to 1 / (k + 1)^s
+    std::vector<int> zipfKeys(const int n, const int count, const double s)
+    {
+        std::vector<double> cdf(n);
+        double total = 0;
+        for (int k = 0; k < n; ++k)
+        {
+            total += 1.0 / std::pow(k + 1, s);
+            cdf[k] = total;
+        }
+        std::mt19937_64 rng(42);
+        std::uniform_real_distribution<double> uniform(0, total);
+        std::vector<int> keys(count);
+        for (int &key : keys)
+        {
+            key = static_cast<int>(std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin());
+            key = std::min(key, n - 1);
+        }
+        return keys;
+    }
+
+    /**
+     * Average number of nodes a get() of @p queries visits, counted as get()
+     * walks: up to the key, the end of the chain or, in hash-sorted chains,
+     * the first larger hash. Performs the lookups, so a reordering map
+     * adapts as it would.
+     */
+    double chainWalk(const HashMap<int, int> &map, const std::vector<int> &queries)
+    {
+        using Internals = HashMapInternals<int, int, 0>;
+        const bool sorted = map.getChainOrder() == ChainOrder::SortedByHash;
+        size_t visited = 0;
+        for (const int key : queries)
+        {
+            const size_t h = std::hash<int>()(key);
+            for (const Node<int, int> *e = Internals::buckets(map)[h & (Internals::capacity(map) - 1)]; e; e = e->next)
+            {
+                ++visited;
+                if (e->key == key || (sorted && e->hash > h)) break;
+            }
+            sink = sink + map.get(key).has_value();
+        }
+        return static_cast<double>(visited) / static_cast<double>(queries.size());
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool with_perf = false;
+    int n = 1000000;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--perf") == 0) with_perf = true;
+        else n = std::stoi(argv[i]);
+    }
+
+    Benchmark bench(with_perf);
+
+    {
+        HashMap<int, int> map;
+        bench.run("int/put (growing)", n, [&]
+        {
+            for (int i = 0; i < n; ++i) map.put(i, i);
+        });
+        bench.run("int/put (update)", n, [&]
+        {
+            for (int i = 0; i < n; ++i) map.put(i, i + 1);
+        });
+        bench.run("int/get (hit)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = 0; i < n; ++i) found += map.get(i).has_value();
+            sink = found;
+        });
+        bench.run("int/get (miss)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = n; i < 2 * n; ++i) found += map.get(i).has_value();
+            sink = found;
+        });
+        const std::string snapshot = "bench_hashmap.snapshot";
+        bench.run("int/save", n, [&]
+        {
+            map.save(snapshot);
+        });
+        HashMap<int, int> loaded;
+        bench.run("int/load", n, [&]
+        {
+            loaded.load(snapshot);
+        });
+        std::remove(snapshot.c_str());
+        const std::string compressed = "bench_hashmap.compressed";
+        bench.run("int/save (compressed)", n, [&]
+        {
+            saveCompressed(map, compressed);
+        });
+        bench.run("int/load (compressed)", n, [&]
+        {
+            loadCompressed(compressed, loaded);
+        });
+        std::remove(compressed.c_str());
+        bench.run("int/remove", n, [&]
+        {
+            for (int i = 0; i < n; ++i) map.remove(i);
+        });
+    }
+
+    {
+        // Same workload on the open-addressing integer map
+        IntHashMap<int, int> map;
+        bench.run("int/put (growing, flat)", n, [&]
+        {
+            for (int i = 0; i < n; ++i) map.put(i, i);
+        });
+        bench.run("int/get (hit, flat)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = 0; i < n; ++i) found += map.get(i).has_value();
+            sink = found;
+        });
+        bench.run("int/get (miss, flat)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = n; i < 2 * n; ++i) found += map.get(i).has_value();
+            sink = found;
+        });
+        bench.run("int/remove (flat)", n, [&]
+        {
+            for (int i = 0; i < n; ++i) map.remove(i);
+        });
+    }
+
+    {
+        // Read-only copy indexed by a minimal perfect hash
+        HashMap<int, int> map;
+        for (int i = 0; i < n; ++i) map.put(i, i);
+        FrozenHashMap<int, int> frozen;
+        bench.run("int/freeze (perfect hash)", n, [&]
+        {
+            frozen = *FrozenHashMap<int, int>::freeze(map);
+        });
+        bench.run("int/get (hit, perfect hash)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = 0; i < n; ++i) found += frozen.get(i).has_value();
+            sink = found;
+        });
+        bench.run("int/get (miss, perfect hash)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = n; i < 2 * n; ++i) found += frozen.get(i).has_value();
+            sink = found;
+        });
+
+        ContiguousHashMap<int, int> contiguous;
+        bench.run("int/freeze (contiguous)", n, [&]
+        {
+            contiguous = ContiguousHashMap<int, int>::freeze(map);
+        });
+        bench.run("int/get (hit, contiguous)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = 0; i < n; ++i) found += contiguous.get(i).has_value();
+            sink = found;
+        });
+    }
+
+    {
+        // Zipf(1.2) lookups: a few hot keys take most of the traffic. Ranks
+        // map to shuffled keys, so hot nodes are scattered over the heap.
+        // With keys that are multiples of 64 (x64), the identity std::hash
+        // uses one bucket in 64 and chains hold ~32 nodes: the cache skips
+        // the walk, which short chains make cheap anyway.
+        std::mt19937_64 rng(7);
+        std::vector<int> ids(n);
+        for (int i = 0; i < n; ++i) ids[i] = i;
+        std::shuffle(ids.begin(), ids.end(), rng);
+        std::vector<int> ranks = zipfKeys(n, n, 1.2);
+        for (int &key : ranks) key = ids[key];
+        std::shuffle(ids.begin(), ids.end(), rng);
+
+        const std::pair<const char *, int> strides[] = {{"", 1}, {", x64", 64}};
+        for (const auto &[label, stride] : strides)
+        {
+            std::vector<int> zipf(ranks);
+            for (int &key : zipf) key *= stride;
+            HashMap<int, int> plain;
+            CachedHashMap<int, int> cached;
+            for (const int i : ids)
+            {
+                plain.put(i * stride, i);
+                cached.put(i * stride, i);
+            }
+            bench.run(std::string("int/get (zipf") + label + ")", n, [&]
+            {
+                size_t found = 0;
+                for (const int key : zipf) found += plain.get(key).has_value();
+                sink = found;
+            });
+            bench.run(std::string("int/get (zipf") + label + ", cached)", n, [&]
+            {
+                size_t found = 0;
+                for (const int key : zipf) found += cached.get(key).has_value();
+                sink = found;
+            });
+        }
+    }
+
+    std::vector<std::pair<std::string, double>> walks;
+    {
+        // Skewed lookups at high load: keys are multiples of 8, so with the
+        // identity std::hash one bucket in eight is used, ~4 keys each
+        std::mt19937_64 rng(11);
+        std::vector<int> ids(n);
+        for (int i = 0; i < n; ++i) ids[i] = i * 8;
+        std::shuffle(ids.begin(), ids.end(), rng);
+        std::vector<int> zipf = zipfKeys(n, n, 1.2);
+        for (int &key : zipf) key = ids[key];
+        std::shuffle(ids.begin(), ids.end(), rng);
+
+        const std::pair<const char *, ChainOrder> orders[] = {
+            {"unordered", ChainOrder::Unordered},
+            {"mtf", ChainOrder::MoveToFront},
+            {"transpose", ChainOrder::Transpose}
+        };
+        for (const auto &[label, order] : orders)
+        {
+            HashMap<int, int> map;
+            map.setChainOrder(order);
+            for (const int i : ids) map.put(i, i);
+            bench.run(std::string("int/get (zipf, ") + label + ")", n, [&]
+            {
+                size_t found = 0;
+                for (const int key : zipf) found += map.get(key).has_value();
+                sink = found;
+            });
+            walks.emplace_back(std::string("int/get (zipf, ") + label + ")", chainWalk(map, zipf));
+        }
+    }
+
+    {
+        // Misses at high load: random multiples of 8 use one bucket in
+        // eight, ~4 keys each; the miss keys land in the same buckets
+        std::mt19937 rng(13);
+        std::vector<int> present(n);
+        std::vector<int> absent(n);
+        for (int &key : present) key = static_cast<int>(rng() >> 5) * 8;
+        for (int &key : absent) key = static_cast<int>(rng() >> 5) * 8;
+        const std::pair<const char *, ChainOrder> orders[] = {
+            {"unordered", ChainOrder::Unordered},
+            {"sorted", ChainOrder::SortedByHash}
+        };
+        for (const auto &[label, order] : orders)
+        {
+            HashMap<int, int> map;
+            map.setChainOrder(order);
+            for (int i = 0; i < n; ++i) map.put(present[i], i);
+            bench.run(std::string("int/get (miss, ") + label + ")", n, [&]
+            {
+                size_t found = 0;
+                for (const int key : absent) found += map.get(key).has_value();
+                sink = found;
+            });
+            walks.emplace_back(std::string("int/get (miss, ") + label + ")", chainWalk(map, absent));
+        }
+    }
+
+    {
+        FilteredHashMap<int, int> filtered;
+        bench.run("int/put (growing, bloom)", n, [&]
+        {
+            for (int i = 0; i < n; ++i) filtered.put(i, i);
+        });
+        bench.run("int/get (hit, bloom)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = 0; i < n; ++i) found += filtered.get(i).has_value();
+            sink = found;
+        });
+        bench.run("int/get (miss, bloom)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = n; i < 2 * n; ++i) found += filtered.get(i).has_value();
+            sink = found;
+        });
+    }
+
+    {
+        // Value scans: node chains vs a separate values column
+        HashMap<int, int> chained;
+        ColumnarHashMap<int, int> columnar;
+        for (int i = 0; i < n; ++i)
+        {
+            chained.put(i, i);
+            columnar.put(i, i);
+        }
+        bench.run("int/sum values (chained)", n, [&]
+        {
+            size_t sum = 0;
+            chained.forEach([&](const int, const int value) { sum += value; });
+            sink = sum;
+        });
+        bench.run("int/sum values (columnar)", n, [&]
+        {
+            size_t sum = 0;
+            columnar.forEachValue([&](const int value) { sum += value; });
+            sink = sum;
+        });
+        bench.run("int/get (hit, columnar)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = 0; i < n; ++i) found += columnar.get(i).has_value();
+            sink = found;
+        });
+    }
+
+    {
+        std::vector<std::string> keys;
+        keys.reserve(n);
+        for (int i = 0; i < n; ++i) keys.push_back("key-" + std::to_string(i));
+        std::vector<std::string> misses;
+        misses.reserve(n);
+        for (int i = 0; i < n; ++i) misses.push_back("miss-" + std::to_string(i));
+
+        HashMap<std::string, int> map;
+        bench.run("string/put (growing)", n, [&]
+        {
+            for (int i = 0; i < n; ++i) map.put(keys[i], i);
+        });
+        bench.run("string/get (hit)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = 0; i < n; ++i) found += map.get(keys[i]).has_value();
+            sink = found;
+        });
+        bench.run("string/get (miss)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = 0; i < n; ++i) found += map.get(misses[i]).has_value();
+            sink = found;
+        });
+        bench.run("string/clear", n, [&]
+        {
+            map.clear();
+        });
+
+        TaggedHashMap<std::string, int> tagged;
+        for (int i = 0; i < n; ++i) tagged.put(keys[i], i);
+        bench.run("string/get (hit, tagged)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = 0; i < n; ++i) found += tagged.get(keys[i]).has_value();
+            sink = found;
+        });
+        bench.run("string/get (miss, tagged)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = 0; i < n; ++i) found += tagged.get(misses[i]).has_value();
+            sink = found;
+        });
+
+        GroupHashMap<std::string, int> grouped;
+        for (int i = 0; i < n; ++i) grouped.put(keys[i], i);
+        bench.run("string/get (hit, grouped)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = 0; i < n; ++i) found += grouped.get(keys[i]).has_value();
+            sink = found;
+        });
+        bench.run("string/get (miss, grouped)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = 0; i < n; ++i) found += grouped.get(misses[i]).has_value();
+            sink = found;
+        });
+
+        FilteredHashMap<std::string, int> filtered;
+        for (int i = 0; i < n; ++i) filtered.put(keys[i], i);
+        bench.run("string/get (miss, bloom)", n, [&]
+        {
+            size_t found = 0;
+            for (int i = 0; i < n; ++i) found += filtered.get(misses[i]).has_value();
+            sink = found;
+        });
+    }
+
+    {
+        // Many tiny maps, as used for per-object attributes
+        const int maps = n / 10;
+        bench.run("tiny maps x6 (chained)", maps, [&]
+        {
+            size_t found = 0;
+            for (int m = 0; m < maps; ++m)
+            {
+                HashMap<int, int> map;
+                for (int i = 0; i < 6; ++i) map.put(i, m);
+                found += map.get(m % 6).has_value();
+            }
+            sink = found;
+        });
+        bench.run("tiny maps x6 (inline N=8)", maps, [&]
+        {
+            size_t found = 0;
+            for (int m = 0; m < maps; ++m)
+            {
+                HashMap<int, int, 8> map;
+                for (int i = 0; i < 6; ++i) map.put(i, m);
+                found += map.get(m % 6).has_value();
+            }
+            sink = found;
+        });
+    }
+
+    bench.report();
+    std::printf("\n%-28s %12s\n", "chain walk", "nodes/get");
+    for (const auto &[name, nodes] : walks) std::printf("%-28s %12.2f\n", name.c_str(), nodes);
+    return 0;
+}
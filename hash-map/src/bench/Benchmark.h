@@ -0,0 +1,143 @@
+#ifndef CPPHASHMAP_BENCHMARK_H
+#define CPPHASHMAP_BENCHMARK_H
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "PerfCounters.h"
+#include "support/AllocCounter.h"
+
+/**
+ * @file Benchmark.h
+ * @brief Minimal benchmark harness.
+ *
+ * Each benchmark is a named region that performs a known number of
+ * operations. The harness measures wall-clock time of the region, heap
+ * allocations (see AllocCounter.h, its .cpp must be linked in) and, when
+ * enabled, hardware counters (see PerfCounters.h), and reports everything
+ * normalized per operation.
+ *
+ * Setup work belongs outside the lambda passed to run(), only the body
+ * is measured.
+ */
+
+struct BenchResult
+{
+    /// Name of the benchmark region
+    std::string name;
+
+    /// Number of operations performed by the region
+    size_t ops;
+
+    /// Wall-clock time of the whole region in nanoseconds
+    double ns;
+
+    /// Heap allocations made inside the region
+    AllocStats allocs;
+
+    /// Hardware counters of the region (all invalid if perf is disabled)
+    PerfSample counters;
+};
+
+class Benchmark
+{
+    /// Counters, nullptr when perf capture is disabled
+    std::unique_ptr<PerfCounters> perf;
+
+    /// Collected results in execution order
+    std::vector<BenchResult> results;
+
+public:
+    /**
+     * @brief Creates a harness.
+     *
+     * @param with_perf try to capture hardware counters. If the kernel does
+     *        not permit any counter, a note is printed and the harness
+     *        falls back to wall-clock time only.
+     */
+    explicit Benchmark(const bool with_perf = false)
+    {
+        if (!with_perf) return;
+        perf = std::make_unique<PerfCounters>();
+        if (!perf->available())
+        {
+            std::fprintf(stderr, "perf counters unavailable "
+                                 "(check /proc/sys/kernel/perf_event_paranoid), "
+                                 "reporting wall-clock time only\n");
+            perf.reset();
+        }
+    }
+
+    /**
+     * @brief Runs and measures one benchmark region.
+     *
+     * @param name name printed in the report
+     * @param ops number of operations the body performs, used for
+     *            per-operation normalization
+     * @param body callable executing the measured region
+     * @return the result, also stored for report()
+     */
+    template <typename F>
+    const BenchResult &run(const std::string &name, const size_t ops, F &&body)
+    {
+        const AllocScope alloc_scope;
+        if (perf) perf->start();
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const auto end = std::chrono::steady_clock::now();
+        PerfSample sample = perf ? perf->stop() : PerfSample{};
+        const AllocStats allocs = alloc_scope.delta();
+
+        const std::chrono::duration<double, std::nano> elapsed = end - start;
+        results.push_back({name, ops, elapsed.count(), allocs, sample});
+        return results.back();
+    }
+
+    /// Returns results collected so far
+    [[nodiscard]] const std::vector<BenchResult> &getResults() const
+    {
+        return results;
+    }
+
+    /// Prints all results as a table with per-operation values
+    void report(std::FILE *out = stdout) const
+    {
+        std::fprintf(out, "%-28s %12s %12s %10s %10s", "benchmark", "ops", "ns/op", "allocs/op", "bytes/op");
+        if (perf)
+        {
+            for (const char *column : PERF_EVENT_NAMES)
+            {
+                std::fprintf(out, " %10s", column);
+            }
+        }
+        std::fprintf(out, "\n");
+
+        for (const BenchResult &r : results)
+        {
+            const double ops = r.ops ? static_cast<double>(r.ops) : 1.0;
+            std::fprintf(out, "%-28s %12zu %12.2f %10.3f %10.1f", r.name.c_str(), r.ops, r.ns / ops,
+                         static_cast<double>(r.allocs.allocations) / ops,
+                         static_cast<double>(r.allocs.bytes_allocated) / ops);
+            if (perf)
+            {
+                for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+                {
+                    if (r.counters.valid[i])
+                    {
+                        std::fprintf(out, " %10.3f", static_cast<double>(r.counters.values[i]) / ops);
+                    }
+                    else
+                    {
+                        std::fprintf(out, " %10s", "n/a");
+                    }
+                }
+            }
+            std::fprintf(out, "\n");
+        }
+    }
+};
+
+#endif //CPPHASHMAP_BENCHMARK_H
@@ -0,0 +1,186 @@
+#ifndef CPPHASHMAP_PERFCOUNTERS_H
+#define CPPHASHMAP_PERFCOUNTERS_H
+
+#include <array>
+#include <cstdint>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file PerfCounters.h
+ * @brief Thin wrapper over Linux hardware performance counters.
+ *
+ * Every counter is opened as an independent perf_event_open file descriptor
+ * for the calling thread (user space only). If the kernel refuses a counter
+ * (perf_event_paranoid, missing PMU, container restrictions, non-Linux build)
+ * that counter is simply marked unavailable and the rest keep working.
+ *
+ * Counters are opened with TOTAL_TIME_ENABLED / TOTAL_TIME_RUNNING so values
+ * are scaled when the kernel multiplexes more events than the PMU supports.
+ */
+
+enum class PerfEvent : size_t
+{
+    Instructions,
+    BranchMisses,
+    L1DMisses,
+    LLCMisses,
+    DTLBMisses,
+    Count
+};
+
+inline constexpr size_t PERF_EVENT_COUNT = static_cast<size_t>(PerfEvent::Count);
+
+/// Short column names for reports, indexed by PerfEvent
+inline constexpr std::array<const char *, PERF_EVENT_COUNT> PERF_EVENT_NAMES = {
+    "instr", "br-miss", "L1D-miss", "LLC-miss", "dTLB-miss"
+};
+
+/// Counter values collected between PerfCounters::start() and stop()
+struct PerfSample
+{
+    /// Counter values, scaled for multiplexing
+    std::array<uint64_t, PERF_EVENT_COUNT> values{};
+
+    /// Whether the corresponding value was actually measured
+    std::array<bool, PERF_EVENT_COUNT> valid{};
+
+    [[nodiscard]] bool has(PerfEvent e) const
+    {
+        return valid[static_cast<size_t>(e)];
+    }
+
+    [[nodiscard]] uint64_t operator[](PerfEvent e) const
+    {
+        return values[static_cast<size_t>(e)];
+    }
+};
+
+class PerfCounters
+{
+    /// File descriptor per event, -1 if unavailable
+    std::array<int, PERF_EVENT_COUNT> fds;
+
+#ifdef __linux__
+    static int open(const uint32_t type, const uint64_t config)
+    {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    static constexpr uint64_t cache(const uint64_t id, const uint64_t op, const uint64_t result)
+    {
+        return id | (op << 8) | (result << 16);
+    }
+#endif
+
+public:
+    /**
+     * @brief Opens all counters that the kernel permits.
+     *
+     * Never fails: unavailable counters are reported through available().
+     */
+    PerfCounters()
+    {
+        fds.fill(-1);
+#ifdef __linux__
+        fds[static_cast<size_t>(PerfEvent::Instructions)] =
+            open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[static_cast<size_t>(PerfEvent::BranchMisses)] =
+            open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+        fds[static_cast<size_t>(PerfEvent::L1DMisses)] =
+            open(PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_L1D,
+                                           PERF_COUNT_HW_CACHE_OP_READ,
+                                           PERF_COUNT_HW_CACHE_RESULT_MISS));
+        fds[static_cast<size_t>(PerfEvent::LLCMisses)] =
+            open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds[static_cast<size_t>(PerfEvent::DTLBMisses)] =
+            open(PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_DTLB,
+                                           PERF_COUNT_HW_CACHE_OP_READ,
+                                           PERF_COUNT_HW_CACHE_RESULT_MISS));
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters()
+    {
+#ifdef __linux__
+        for (const int fd : fds)
+        {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    /// Checks whether at least one counter could be opened
+    [[nodiscard]] bool available() const
+    {
+        for (const int fd : fds)
+        {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    /// Checks whether the given counter could be opened
+    [[nodiscard]] bool available(PerfEvent e) const
+    {
+        return fds[static_cast<size_t>(e)] >= 0;
+    }
+
+    /// Resets and enables all available counters
+    void start()
+    {
+#ifdef __linux__
+        for (const int fd : fds)
+        {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /**
+     * @brief Disables all counters and returns their values since start().
+     *
+     * Values are scaled by enabled/running time when the event was
+     * multiplexed. A counter that never got scheduled is marked invalid.
+     */
+    PerfSample stop()
+    {
+        PerfSample sample;
+#ifdef __linux__
+        for (const int fd : fds)
+        {
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+        {
+            if (fds[i] < 0) continue;
+            uint64_t data[3] = {};
+            if (read(fds[i], data, sizeof(data)) != sizeof(data) || data[2] == 0) continue;
+            const double scale = static_cast<double>(data[1]) / static_cast<double>(data[2]);
+            sample.values[i] = static_cast<uint64_t>(static_cast<double>(data[0]) * scale);
+            sample.valid[i] = true;
+        }
+#endif
+        return sample;
+    }
+};
+
+#endif //CPPHASHMAP_PERFCOUNTERS_H
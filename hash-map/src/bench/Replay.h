@@ -0,0 +1,141 @@
+#ifndef CPPHASHMAP_REPLAY_H
+#define CPPHASHMAP_REPLAY_H
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "Trace.h"
+#include "support/AllocCounter.h"
+
+/**
+ * @file Replay.h
+ * @brief Replays a recorded trace through any map engine.
+ *
+ * The engine only needs put(k, v), get(k), remove(k) and clear(), so
+ * HashMap and any alternative implementation can be compared on the same
+ * recorded access pattern.
+ *
+ * The trace is decoded up front, then replayed twice on fresh maps:
+ * once untimed per operation for throughput, once with a clock read around
+ * every operation for the latency distribution.
+ *
+ * Heap figures come from AllocCounter.h, its .cpp must be linked in.
+ */
+
+struct ReplayStats
+{
+    /// Number of replayed operations
+    size_t ops = 0;
+
+    /// Throughput pass wall-clock time
+    double seconds = 0;
+
+    /// Latency percentiles in nanoseconds
+    double p50_ns = 0;
+    double p90_ns = 0;
+    double p99_ns = 0;
+    double p999_ns = 0;
+    double max_ns = 0;
+
+    /// Peak live heap bytes allocated by the map during the throughput pass
+    size_t peak_heap_bytes = 0;
+
+    /// Heap allocations made during the throughput pass
+    size_t allocations = 0;
+
+    /// Peak resident set size of the process in KiB
+    long peak_rss_kb = 0;
+
+    [[nodiscard]] double opsPerSecond() const
+    {
+        return seconds > 0 ? static_cast<double>(ops) / seconds : 0;
+    }
+};
+
+namespace replay_detail
+{
+    inline volatile size_t sink = 0;
+
+    template <typename Map, typename K, typename V>
+    void apply(Map &map, const TraceRecord<K, V> &r)
+    {
+        switch (r.op)
+        {
+            case TraceOp::Put:
+                map.put(r.key, r.value);
+                break;
+            case TraceOp::Get:
+                sink = sink + map.get(r.key).has_value();
+                break;
+            case TraceOp::Remove:
+                map.remove(r.key);
+                break;
+            case TraceOp::Clear:
+                map.clear();
+                break;
+        }
+    }
+
+    inline double percentile(const std::vector<double> &sorted, const double p)
+    {
+        if (sorted.empty()) return 0;
+        const auto i = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+        return sorted[i];
+    }
+}
+
+/**
+ * @brief Replays @p records through default-constructed instances of Map.
+ *
+ * @tparam Map engine type, constructed fresh for each pass
+ */
+template <typename Map, typename K, typename V>
+ReplayStats replay(const std::vector<TraceRecord<K, V>> &records)
+{
+    using clock = std::chrono::steady_clock;
+    ReplayStats stats;
+    stats.ops = records.size();
+
+    {
+        const AllocScope scope;
+        Map map;
+        const auto start = clock::now();
+        for (const TraceRecord<K, V> &r : records)
+        {
+            replay_detail::apply(map, r);
+        }
+        const std::chrono::duration<double> elapsed = clock::now() - start;
+        stats.seconds = elapsed.count();
+        stats.peak_heap_bytes = scope.peakBytes();
+        stats.allocations = scope.allocations();
+
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        stats.peak_rss_kb = usage.ru_maxrss;
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(records.size());
+    {
+        Map map;
+        for (const TraceRecord<K, V> &r : records)
+        {
+            const auto start = clock::now();
+            replay_detail::apply(map, r);
+            const std::chrono::duration<double, std::nano> elapsed = clock::now() - start;
+            latencies.push_back(elapsed.count());
+        }
+    }
+    std::sort(latencies.begin(), latencies.end());
+    stats.p50_ns = replay_detail::percentile(latencies, 0.50);
+    stats.p90_ns = replay_detail::percentile(latencies, 0.90);
+    stats.p99_ns = replay_detail::percentile(latencies, 0.99);
+    stats.p999_ns = replay_detail::percentile(latencies, 0.999);
+    stats.max_ns = latencies.empty() ? 0 : latencies.back();
+    return stats;
+}
+
+#endif //CPPHASHMAP_REPLAY_H
@@ -0,0 +1,92 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "CachedHashMap.h"
+#include "ColumnarHashMap.h"
+#include "FilteredHashMap.h"
+#include "GroupHashMap.h"
+#include "HashMap.h"
+#include "IntHashMap.h"
+#include "OrderedHashMap.h"
+#include "Replay.h"
+#include "TaggedHashMap.h"
+
+/**
+ * Replays a recorded trace (see Trace.h) and reports throughput,
+ * latency percentiles and peak memory.
+ *
+ * Usage: replay_trace <trace> [--types=u64|string] [--engine=NAME]
+ *     --types   key and value types the trace was recorded with:
+ *               u64    <uint64_t, uint64_t> (default)
+ *               string <std::string, std::string>
+ *     --engine  map the trace is replayed against:
+ *               hashmap (default), int (u64 only), columnar, group,
+ *               tagged, ordered, filtered, cached
+ */
+
+namespace
+{
+    template <typename Map, typename K, typename V>
+    int replayWith(const char *engine, const std::vector<TraceRecord<K, V>> &records)
+    {
+        const ReplayStats s = replay<Map>(records);
+        std::printf("engine       %s\n", engine);
+        std::printf("ops          %zu\n", s.ops);
+        std::printf("throughput   %.0f ops/s\n", s.opsPerSecond());
+        std::printf("latency ns   p50 %.0f  p90 %.0f  p99 %.0f  p99.9 %.0f  max %.0f\n",
+                    s.p50_ns, s.p90_ns, s.p99_ns, s.p999_ns, s.max_ns);
+        std::printf("peak heap    %zu bytes (%zu allocations)\n", s.peak_heap_bytes, s.allocations);
+        std::printf("peak RSS     %ld KiB\n", s.peak_rss_kb);
+        return 0;
+    }
+
+    template <typename K, typename V>
+    int run(const char *path, const std::string &engine)
+    {
+        TraceReader<K, V> reader(path);
+        const std::vector<TraceRecord<K, V>> records = reader.readAll();
+        if (!reader.ok())
+        {
+            std::fprintf(stderr, "%s: invalid or truncated trace\n", path);
+            return 1;
+        }
+
+        const char *name = engine.c_str();
+        if (engine == "hashmap") return replayWith<HashMap<K, V>>(name, records);
+        if constexpr (std::is_integral_v<K>)
+        {
+            if (engine == "int") return replayWith<IntHashMap<K, V>>(name, records);
+        }
+        if (engine == "columnar") return replayWith<ColumnarHashMap<K, V>>(name, records);
+        if (engine == "group") return replayWith<GroupHashMap<K, V>>(name, records);
+        if (engine == "tagged") return replayWith<TaggedHashMap<K, V>>(name, records);
+        if (engine == "ordered") return replayWith<OrderedHashMap<K, V>>(name, records);
+        if (engine == "filtered") return replayWith<FilteredHashMap<K, V>>(name, records);
+        if (engine == "cached") return replayWith<CachedHashMap<K, V>>(name, records);
+        std::fprintf(stderr, "unknown --engine=%s for these --types\n", name);
+        return 2;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <trace> [--types=u64|string] [--engine=NAME]\n", argv[0]);
+        return 2;
+    }
+    std::string types = "u64";
+    std::string engine = "hashmap";
+    for (int i = 2; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--types=", 8) == 0) types = argv[i] + 8;
+        else if (std::strncmp(argv[i], "--engine=", 9) == 0) engine = argv[i] + 9;
+    }
+
+    if (types == "u64") return run<uint64_t, uint64_t>(argv[1], engine);
+    if (types == "string") return run<std::string, std::string>(argv[1], engine);
+    std::fprintf(stderr, "unknown --types=%s\n", types.c_str());
+    return 2;
+}
@@ -0,0 +1,207 @@
+#include "AllocCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/**
+ * Replacement global allocation functions.
+ *
+ * Every block carries a small header in front of the user pointer holding
+ * the requested size, so unsized operator delete can still account freed
+ * bytes and the live heap size.
+ */
+
+namespace
+{
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> deallocations{0};
+    std::atomic<size_t> bytes_allocated{0};
+    std::atomic<size_t> bytes_freed{0};
+    std::atomic<size_t> live{0};
+    std::atomic<size_t> peak{0};
+
+    constexpr size_t HEADER = alignof(std::max_align_t);
+
+    void recordAlloc(const size_t size)
+    {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+        const size_t now = live.fetch_add(size, std::memory_order_relaxed) + size;
+        size_t seen = peak.load(std::memory_order_relaxed);
+        while (now > seen && !peak.compare_exchange_weak(seen, now, std::memory_order_relaxed)) {}
+    }
+
+    void recordFree(const size_t size)
+    {
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+        bytes_freed.fetch_add(size, std::memory_order_relaxed);
+        live.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    /// Allocates @p size bytes aligned to @p align (>= HEADER), nullptr on failure
+    void *allocate(const size_t size, const size_t align)
+    {
+        const size_t total = (size + align + align - 1) / align * align;
+        char *base = static_cast<char *>(align == HEADER ? std::malloc(size + HEADER)
+                                                         : std::aligned_alloc(align, total));
+        if (!base) return nullptr;
+        char *user = base + align;
+        *reinterpret_cast<size_t *>(user - sizeof(size_t)) = size;
+        recordAlloc(size);
+        return user;
+    }
+
+    void deallocate(void *ptr, const size_t align)
+    {
+        if (!ptr) return;
+        char *user = static_cast<char *>(ptr);
+        recordFree(*reinterpret_cast<size_t *>(user - sizeof(size_t)));
+        std::free(user - align);
+    }
+
+    void *allocateOrThrow(const size_t size, const size_t align)
+    {
+        while (true)
+        {
+            if (void *p = allocate(size, align)) return p;
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    size_t alignOf(const std::align_val_t al)
+    {
+        const auto align = static_cast<size_t>(al);
+        return align < HEADER ? HEADER : align;
+    }
+}
+
+namespace alloc_counter
+{
+    AllocStats snapshot()
+    {
+        return {
+            allocations.load(std::memory_order_relaxed),
+            deallocations.load(std::memory_order_relaxed),
+            bytes_allocated.load(std::memory_order_relaxed),
+            bytes_freed.load(std::memory_order_relaxed)
+        };
+    }
+
+    size_t liveBytes()
+    {
+        return live.load(std::memory_order_relaxed);
+    }
+
+    size_t peakBytes()
+    {
+        return peak.load(std::memory_order_relaxed);
+    }
+
+    void resetPeak()
+    {
+        peak.store(live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+void *operator new(const size_t size)
+{
+    return allocateOrThrow(size, HEADER);
+}
+
+void *operator new[](const size_t size)
+{
+    return allocateOrThrow(size, HEADER);
+}
+
+void *operator new(const size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size, HEADER);
+}
+
+void *operator new[](const size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size, HEADER);
+}
+
+void *operator new(const size_t size, const std::align_val_t al)
+{
+    return allocateOrThrow(size, alignOf(al));
+}
+
+void *operator new[](const size_t size, const std::align_val_t al)
+{
+    return allocateOrThrow(size, alignOf(al));
+}
+
+void *operator new(const size_t size, const std::align_val_t al, const std::nothrow_t &) noexcept
+{
+    return allocate(size, alignOf(al));
+}
+
+void *operator new[](const size_t size, const std::align_val_t al, const std::nothrow_t &) noexcept
+{
+    return allocate(size, alignOf(al));
+}
+
+void operator delete(void *ptr) noexcept
+{
+    deallocate(ptr, HEADER);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    deallocate(ptr, HEADER);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    deallocate(ptr, HEADER);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    deallocate(ptr, HEADER);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    deallocate(ptr, HEADER);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    deallocate(ptr, HEADER);
+}
+
+void operator delete(void *ptr, const std::align_val_t al) noexcept
+{
+    deallocate(ptr, alignOf(al));
+}
+
+void operator delete[](void *ptr, const std::align_val_t al) noexcept
+{
+    deallocate(ptr, alignOf(al));
+}
+
+void operator delete(void *ptr, size_t, const std::align_val_t al) noexcept
+{
+    deallocate(ptr, alignOf(al));
+}
+
+void operator delete[](void *ptr, size_t, const std::align_val_t al) noexcept
+{
+    deallocate(ptr, alignOf(al));
+}
+
+void operator delete(void *ptr, const std::align_val_t al, const std::nothrow_t &) noexcept
+{
+    deallocate(ptr, alignOf(al));
+}
+
+void operator delete[](void *ptr, const std::align_val_t al, const std::nothrow_t &) noexcept
+{
+    deallocate(ptr, alignOf(al));
+}
@@ -0,0 +1,104 @@
+#ifndef CPPHASHMAP_ALLOCCOUNTER_H
+#define CPPHASHMAP_ALLOCCOUNTER_H
+
+#include <cstddef>
+
+/**
+ * @file AllocCounter.h
+ * @brief Counting of global operator new / operator delete.
+ *
+ * AllocCounter.cpp replaces every global allocation function and keeps
+ * process-wide counters of calls, bytes and live heap size. Link that
+ * translation unit into a test or benchmark binary to enable counting;
+ * without it the functions below are undefined.
+ *
+ * Typical use is an AllocScope around the region under test:
+ *
+ *     AllocScope scope;
+ *     map.get(key);
+ *     EXPECT_EQ(scope.allocations(), 0);
+ *
+ * Counters are global and shared by all threads, so a scope also sees
+ * allocations made concurrently by other threads.
+ */
+
+struct AllocStats
+{
+    /// Number of operator new calls
+    size_t allocations = 0;
+
+    /// Number of operator delete calls with a non-null pointer
+    size_t deallocations = 0;
+
+    /// Bytes requested from operator new
+    size_t bytes_allocated = 0;
+
+    /// Bytes returned through operator delete
+    size_t bytes_freed = 0;
+};
+
+namespace alloc_counter
+{
+    /// Returns the counters accumulated since process start
+    AllocStats snapshot();
+
+    /// Returns the current number of live heap bytes
+    size_t liveBytes();
+
+    /// Returns the highest live heap size since the last resetPeak()
+    size_t peakBytes();
+
+    /// Restarts peak tracking from the current live heap size
+    void resetPeak();
+}
+
+/**
+ * @brief Measures allocations made between construction and the query.
+ *
+ * Also restarts peak tracking, so peakBytes() reports the highest live
+ * heap size reached inside the scope. Nested scopes share the peak.
+ */
+class AllocScope
+{
+    AllocStats start;
+    size_t start_live;
+
+public:
+    AllocScope() : start(alloc_counter::snapshot()), start_live(alloc_counter::liveBytes())
+    {
+        alloc_counter::resetPeak();
+    }
+
+    /// Returns counter differences since construction
+    [[nodiscard]] AllocStats delta() const
+    {
+        const AllocStats now = alloc_counter::snapshot();
+        return {
+            now.allocations - start.allocations,
+            now.deallocations - start.deallocations,
+            now.bytes_allocated - start.bytes_allocated,
+            now.bytes_freed - start.bytes_freed
+        };
+    }
+
+    /// Number of operator new calls since construction
+    [[nodiscard]] size_t allocations() const
+    {
+        return delta().allocations;
+    }
+
+    /// Bytes requested since construction
+    [[nodiscard]] size_t bytes() const
+    {
+        return delta().bytes_allocated;
+    }
+
+    /// Peak live heap size inside the scope, relative to its start
+    [[nodiscard]] size_t peakBytes() const
+    {
+        const size_t peak = alloc_counter::peakBytes();
+        return peak > start_live ? peak - start_live : 0;
+    }
+};
+
+#endif //CPPHASHMAP_ALLOCCOUNTER_H
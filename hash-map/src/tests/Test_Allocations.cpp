@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include "HashMap.h"
+#include "support/AllocCounter.h"
+
+/**
+ * Allocation budgets of HashMap.
+ * Requires support/AllocCounter.cpp to be linked into the test binary.
+ */
+
+TEST(Allocations, CounterSeesAllocations)
+{
+    AllocScope scope;
+    int *p = new int(1);
+    EXPECT_EQ(scope.allocations(), 1);
+    EXPECT_EQ(scope.bytes(), sizeof(int));
+    EXPECT_EQ(scope.peakBytes(), sizeof(int));
+    delete p;
+    EXPECT_EQ(scope.delta().deallocations, 1);
+    EXPECT_EQ(scope.delta().bytes_freed, sizeof(int));
+}
+
+TEST(Allocations, GetAllocatesNothing)
+{
+    HashMap<int, int> map;
+    for (int i = 0; i < 1000; ++i) map.put(i, i);
+
+    AllocScope scope;
+    for (int i = 0; i < 2000; ++i) (void)map.get(i);
+    EXPECT_EQ(scope.allocations(), 0);
+}
+
+TEST(Allocations, UpdateAllocatesNothing)
+{
+    HashMap<int, int> map;
+    for (int i = 0; i < 1000; ++i) map.put(i, i);
+
+    AllocScope scope;
+    for (int i = 0; i < 1000; ++i) map.put(i, i + 1);
+    EXPECT_EQ(scope.allocations(), 0);
+}
+
+TEST(Allocations, RemoveAllocatesNothing)
+{
+    HashMap<int, int> map;
+    for (int i = 0; i < 1000; ++i) map.put(i, i);
+
+    AllocScope scope;
+    for (int i = 0; i < 1000; ++i) map.remove(i);
+    EXPECT_EQ(scope.allocations(), 0);
+    EXPECT_EQ(scope.delta().deallocations, 1000);
+}
+
+TEST(Allocations, InsertBudget)
+{
+    HashMap<int, int> map;
+
+    // Bucket array on the first insert, then one node per new key while
+    // the threshold holds
+    AllocScope scope;
+    for (int i = 0; i < 12; ++i) map.put(i, i);
+    const AllocStats stats = scope.delta();
+    EXPECT_EQ(stats.allocations, 13);
+    EXPECT_EQ(stats.bytes_allocated, 12 * sizeof(Node<int, int>) + 16 * sizeof(Node<int, int> *));
+
+    // Crossing the threshold allocates exactly one new bucket array
+    AllocScope resize_scope;
+    map.put(12, 12);
+    EXPECT_EQ(resize_scope.allocations(), 2);
+    EXPECT_EQ(resize_scope.bytes(), sizeof(Node<int, int>) + 32 * sizeof(Node<int, int> *));
+}
+
+TEST(Allocations, ClearRefillAllocatesNothing)
+{
+    HashMap<int, int> map;
+    for (int i = 0; i < 1000; ++i) map.put(i, i);
+    map.clear();
+
+    AllocScope scope;
+    for (int i = 0; i < 1000; ++i) map.put(i + 5000, i);
+    EXPECT_EQ(scope.allocations(), 0);
+    EXPECT_EQ(map.size(), 1000);
+    EXPECT_EQ(map.get(5999), 999);
+}
+
+TEST(Allocations, ResetReleasesEverything)
+{
+    const size_t live = alloc_counter::liveBytes();
+    {
+        HashMap<std::string, int> map;
+        for (int i = 0; i < 100; ++i) map.put("key-number-" + std::to_string(i), i);
+        map.clear();
+        map.reset();
+        for (int i = 0; i < 10; ++i) map.put("key-number-" + std::to_string(i), i);
+    }
+    EXPECT_EQ(alloc_counter::liveBytes(), live);
+}
+
+TEST(Allocations, SmallMapAllocatesNothingUntilGrowth)
+{
+    AllocScope scope;
+    {
+        HashMap<int, int, 8> map;
+        for (int i = 0; i < 8; ++i) map.put(i, i);
+        for (int i = 0; i < 8; ++i) EXPECT_EQ(map.get(i), i);
+        map.remove(0);
+        map.clear();
+    }
+    EXPECT_EQ(scope.allocations(), 0);
+
+    HashMap<int, int, 8> map;
+    for (int i = 0; i < 8; ++i) map.put(i, i);
+    AllocScope spill_scope;
+    map.put(8, 8);
+    // One bucket array plus one node per entry
+    EXPECT_EQ(spill_scope.allocations(), 10);
+}
+
+TEST(Allocations, EmptyMapAllocatesNothing)
+{
+    AllocScope scope;
+    {
+        HashMap<std::string, int> map;
+        EXPECT_EQ(map.get("ghost"), std::nullopt);
+        EXPECT_FALSE(map.remove("ghost"));
+        map.clear();
+        map.reset();
+        HashMap<std::string, int> moved(std::move(map));
+    }
+    EXPECT_EQ(scope.allocations(), 0);
+}
+
+TEST(Allocations, ResetAndMoveReleaseBuckets)
+{
+    HashMap<int, int> map;
+    map.put(1, 1);
+    map.reset();
+    HashMap<int, int> other;
+    other.put(2, 2);
+    map = std::move(other);
+
+    AllocScope scope;
+    map.reset();
+    other.reset();
+    HashMap<int, int> moved(std::move(other));
+    EXPECT_EQ(scope.allocations(), 0);
+
+    // First insert allocates the bucket array and one node
+    AllocScope insert_scope;
+    map.put(3, 3);
+    EXPECT_EQ(insert_scope.allocations(), 2);
+}
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "CachedHashMap.h"
+
+TEST(CachedHashMap, RemoveThenReinsertInSameSet)
+{
+    // One set of two ways: every key competes for the same cache lines
+    CachedHashMap<std::string, std::string> map(2);
+    map.put("hot", "1");
+    map.put("cold", "2");
+    EXPECT_EQ(map.get("hot"), "1");
+    EXPECT_EQ(map.get("hot"), "1");
+    EXPECT_EQ(map.get("cold"), "2");
+
+    // The freed node is recycled for a different key of the same set
+    EXPECT_TRUE(map.remove("hot"));
+    map.put("other", "3");
+    EXPECT_EQ(map.get("hot"), std::nullopt);
+    EXPECT_EQ(map.get("other"), "3");
+    EXPECT_EQ(map.get("other"), "3");
+    EXPECT_EQ(map.get("cold"), "2");
+
+    EXPECT_TRUE(map.remove("cold"));
+    map.put("hot", "4");
+    EXPECT_EQ(map.get("cold"), std::nullopt);
+    EXPECT_EQ(map.get("hot"), "4");
+    EXPECT_EQ(map.get("other"), "3");
+
+    // Cached nodes see updates and survive growth; clear() drops them
+    map.put("hot", "5");
+    for (int i = 0; i < 1000; ++i) map.put("key-" + std::to_string(i), std::to_string(i));
+    EXPECT_EQ(map.get("hot"), "5");
+    map.clear();
+    map.put("new", "6");
+    EXPECT_EQ(map.get("hot"), std::nullopt);
+    EXPECT_EQ(map.get("new"), "6");
+}
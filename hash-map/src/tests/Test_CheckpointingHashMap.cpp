@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <thread>
+#include <sys/stat.h>
+#include "CheckpointingHashMap.h"
+
+TEST(CheckpointingHashMap, PointInTimeDespiteMutations)
+{
+    const std::string path = ::testing::TempDir() + "checkpoint_point_in_time.bin";
+    CheckpointingHashMap<int, int> map;
+    for (int i = 0; i < 20000; ++i) map.put(i, i);
+
+    ASSERT_TRUE(map.checkpoint(path));
+    // Updates, removes and enough inserts to resize, racing the writer
+    for (int i = 0; i < 20000; ++i) map.put(i, -i);
+    for (int i = 0; i < 20000; i += 3) map.remove(i);
+    for (int i = 20000; i < 60000; ++i) map.put(i, i);
+    ASSERT_TRUE(map.waitCheckpoint());
+    EXPECT_FALSE(map.checkpointRunning());
+
+    HashMap<int, int> loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.size(), 20000);
+    for (int i = 0; i < 20000; ++i) EXPECT_EQ(loaded.get(i), i);
+    EXPECT_EQ(loaded.get(20000), std::nullopt);
+
+    EXPECT_EQ(map.get(3), std::nullopt);
+    EXPECT_EQ(map.get(4), -4);
+    EXPECT_EQ(map.size(), 60000 - 6667);
+    std::remove(path.c_str());
+}
+
+TEST(CheckpointingHashMap, ClearAndConcurrentWriters)
+{
+    const std::string path = ::testing::TempDir() + "checkpoint_clear.bin";
+    CheckpointingHashMap<std::string, int> map;
+    for (int i = 0; i < 5000; ++i) map.put("key" + std::to_string(i), i);
+
+    ASSERT_TRUE(map.checkpoint(path));
+    std::thread other([&]
+    {
+        for (int i = 0; i < 5000; ++i) map.put("other" + std::to_string(i), i);
+    });
+    map.clear();
+    other.join();
+    ASSERT_TRUE(map.waitCheckpoint());
+
+    HashMap<std::string, int> loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.size(), 5000);
+    EXPECT_EQ(loaded.get("key4999"), 4999);
+    EXPECT_EQ(loaded.get("other0"), std::nullopt);
+
+    // A second checkpoint after the first one finished
+    ASSERT_TRUE(map.checkpoint(path));
+    ASSERT_TRUE(map.waitCheckpoint());
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.size(), map.size());
+    std::remove(path.c_str());
+}
+
+TEST(CheckpointingHashMap, SecondCheckpointFailsWhileRunning)
+{
+    const std::string path = ::testing::TempDir() + "checkpoint_in_flight.bin";
+    const std::string tmp = path + ".tmp";
+    std::remove(path.c_str());
+    std::remove(tmp.c_str());
+    // The writer blocks opening the FIFO until the test opens the read end
+    ASSERT_EQ(mkfifo(tmp.c_str(), 0600), 0);
+
+    CheckpointingHashMap<int, int> map;
+    for (int i = 0; i < 100; ++i) map.put(i, i);
+    ASSERT_TRUE(map.checkpoint(path));
+    EXPECT_TRUE(map.checkpointRunning());
+    EXPECT_FALSE(map.checkpoint(path));
+    map.put(100, 100);
+
+    std::FILE *f = std::fopen(tmp.c_str(), "rb");
+    ASSERT_NE(f, nullptr);
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    ASSERT_EQ(std::fread(magic, 1, sizeof(magic), f), sizeof(magic));
+    EXPECT_TRUE(std::equal(magic, magic + sizeof(magic), SNAPSHOT_MAGIC));
+    while (std::fgetc(f) != EOF) {}
+    std::fclose(f);
+    EXPECT_TRUE(map.waitCheckpoint());
+    EXPECT_FALSE(map.checkpointRunning());
+
+    std::remove(path.c_str());
+    ASSERT_TRUE(map.checkpoint(path));
+    ASSERT_TRUE(map.waitCheckpoint());
+    HashMap<int, int> loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.size(), 101);
+    std::remove(path.c_str());
+}
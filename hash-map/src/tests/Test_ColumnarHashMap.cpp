@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include "ColumnarHashMap.h"
+
+template<typename K, typename V>
+std::vector<K> slotOrder(const ColumnarHashMap<K, V> &map)
+{
+    std::vector<K> keys;
+    map.forEach([&](const K &key, const V &) { keys.push_back(key); });
+    return keys;
+}
+
+/// First @p n non-negative keys whose home slot in a 16-slot table is @p slot
+std::vector<int> keysWithHome(const size_t slot, const size_t n)
+{
+    std::vector<int> keys;
+    for (int key = 0; keys.size() < n; ++key)
+    {
+        // Same mixing as ColumnarHashMap::storedHash()
+        uint64_t m = static_cast<uint64_t>(key) * 0x9e3779b97f4a7c15ull;
+        m ^= m >> 32;
+        if ((m & 15) == slot) keys.push_back(key);
+    }
+    return keys;
+}
+
+TEST(ColumnarHashMap, BackwardShiftAcrossWraparound)
+{
+    // 16 slots: a, b, c, d start at slot 14 and wrap to slots 0 and 1,
+    // e (home 0) and f (home 1) are pushed behind them
+    const std::vector<int> home14 = keysWithHome(14, 4);
+    const int a = home14[0], b = home14[1], c = home14[2], d = home14[3];
+    const int e = keysWithHome(0, 1)[0];
+    const int f = keysWithHome(1, 1)[0];
+    ColumnarHashMap<int, int> map;
+    for (const int key : {a, b, c, d, e, f}) map.put(key, key * 10);
+    EXPECT_EQ(slotOrder(map), (std::vector<int>{c, d, e, f, a, b}));
+
+    // The hole at slot 15 is filled across the end of the table
+    EXPECT_TRUE(map.remove(b));
+    EXPECT_EQ(slotOrder(map), (std::vector<int>{d, e, f, a, c}));
+    EXPECT_TRUE(map.remove(a));
+    EXPECT_EQ(slotOrder(map), (std::vector<int>{e, f, c, d}));
+    for (const int key : {e, f, c, d}) EXPECT_EQ(map.get(key), key * 10);
+    EXPECT_EQ(map.get(a), std::nullopt);
+    EXPECT_EQ(map.get(b), std::nullopt);
+}
+
+TEST(ColumnarHashMap, ForEachValue)
+{
+    ColumnarHashMap<int, int> map;
+    for (int i = 0; i < 1000; ++i) map.put(i, i * 2);
+    map.put(0, 7);
+    EXPECT_TRUE(map.remove(500));
+    long long sum = 0;
+    map.forEachValue([&](const int value) { sum += value; });
+    EXPECT_EQ(sum, 999LL * 1000 - 1000 + 7);
+
+    // Backward shifts move entries; the scan must see exactly the survivors
+    for (int i = 1; i < 1000; i += 2) EXPECT_TRUE(map.remove(i));
+    size_t count = 0;
+    sum = 0;
+    map.forEachValue([&](const int value) { sum += value; ++count; });
+    EXPECT_EQ(count, map.size());
+    EXPECT_EQ(sum, 499LL * 500 * 2 - 1000 + 7);
+
+    map.clear();
+    map.forEachValue([&](const int) { ADD_FAILURE(); });
+    map.reset();
+    map.forEachValue([&](const int) { ADD_FAILURE(); });
+    map.put(3, 30);
+    sum = 0;
+    map.forEachValue([&](const int value) { sum += value; });
+    EXPECT_EQ(sum, 30);
+}
+
+TEST(ColumnarHashMap, StridedIntegerKeys)
+{
+    // Identity hashes with equal low 16 bits form one probe run unless mixed
+    ColumnarHashMap<int64_t, int64_t> map;
+    for (int64_t i = 0; i < 100000; ++i) map.put(i << 16, i);
+    EXPECT_EQ(map.size(), 100000);
+    for (int64_t i = 0; i < 100000; ++i) EXPECT_EQ(map.get(i << 16), i);
+    EXPECT_TRUE(map.remove(0));
+    EXPECT_EQ(map.get(0), std::nullopt);
+    EXPECT_EQ(map.get(1), std::nullopt);
+}
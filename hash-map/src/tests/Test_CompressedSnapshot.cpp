@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "CompressedSnapshot.h"
+
+namespace
+{
+    size_t fileSize(const std::string &path)
+    {
+        struct stat st{};
+        return ::stat(path.c_str(), &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+    }
+}
+
+TEST(CompressedSnapshot, SequentialIntsAreSmall)
+{
+    const std::string raw = ::testing::TempDir() + "compressed_raw.bin";
+    const std::string packed = ::testing::TempDir() + "compressed_ints.bin";
+    HashMap<int, int> map;
+    for (int i = 0; i < 100000; ++i) map.put(i * 3, 1000 + i % 50);
+    map.remove(300);
+    ASSERT_TRUE(map.save(raw));
+    ASSERT_TRUE(saveCompressed(map, packed));
+    EXPECT_LT(fileSize(packed) * 4, fileSize(raw));
+
+    HashMap<int, int> loaded;
+    loaded.put(-5, 5);
+    ASSERT_TRUE(loadCompressed(packed, loaded));
+    EXPECT_EQ(loaded.size(), map.size());
+    EXPECT_EQ(loaded.get(-5), std::nullopt);
+    EXPECT_EQ(loaded.get(300), std::nullopt);
+    for (int i = 0; i < 100000; ++i)
+    {
+        if (i != 100)
+        {
+            EXPECT_EQ(loaded.get(i * 3), 1000 + i % 50);
+        }
+    }
+    std::remove(raw.c_str());
+    std::remove(packed.c_str());
+}
+
+TEST(CompressedSnapshot, ExtremeValues)
+{
+    const std::string path = ::testing::TempDir() + "compressed_extreme.bin";
+    HashMap<int64_t, int64_t> map;
+    map.put(INT64_MIN, INT64_MAX);
+    map.put(INT64_MAX, INT64_MIN);
+    map.put(0, -1);
+    map.put(-1, 0);
+    ASSERT_TRUE(saveCompressed(map, path));
+
+    HashMap<int64_t, int64_t> loaded;
+    ASSERT_TRUE(loadCompressed(path, loaded));
+    EXPECT_EQ(loaded.size(), 4);
+    EXPECT_EQ(loaded.get(INT64_MIN), INT64_MAX);
+    EXPECT_EQ(loaded.get(INT64_MAX), INT64_MIN);
+    EXPECT_EQ(loaded.get(0), -1);
+    EXPECT_EQ(loaded.get(-1), 0);
+    std::remove(path.c_str());
+}
+
+TEST(CompressedSnapshot, StringValuesAndSmallMap)
+{
+    const std::string path = ::testing::TempDir() + "compressed_strings.bin";
+    HashMap<uint32_t, std::string> map;
+    for (uint32_t i = 0; i < 300; ++i) map.put(i * i, std::to_string(i));
+    ASSERT_TRUE(saveCompressed(map, path));
+
+    HashMap<uint32_t, std::string> loaded;
+    ASSERT_TRUE(loadCompressed(path, loaded));
+    EXPECT_EQ(loaded.size(), 300);
+    for (uint32_t i = 0; i < 300; ++i) EXPECT_EQ(loaded.get(i * i), std::to_string(i));
+
+    HashMap<int, int, 4> small;
+    small.put(7, 70);
+    small.put(-7, -70);
+    ASSERT_TRUE(saveCompressed(small, path));
+    HashMap<int, int, 4> small_loaded;
+    ASSERT_TRUE(loadCompressed(path, small_loaded));
+    EXPECT_EQ(small_loaded.size(), 2);
+    EXPECT_EQ(small_loaded.get(-7), -70);
+
+    HashMap<int, int> empty;
+    ASSERT_TRUE(saveCompressed(empty, path));
+    ASSERT_TRUE(loadCompressed(path, small_loaded));
+    EXPECT_TRUE(small_loaded.empty());
+    std::remove(path.c_str());
+}
+
+TEST(CompressedSnapshot, RejectsTruncatedFile)
+{
+    const std::string path = ::testing::TempDir() + "compressed_truncated.bin";
+    HashMap<int, int> map;
+    for (int i = 0; i < 1000; ++i) map.put(i, i);
+    ASSERT_TRUE(saveCompressed(map, path));
+    ASSERT_EQ(::truncate(path.c_str(), static_cast<off_t>(fileSize(path) - 10)), 0);
+
+    HashMap<int, int> loaded;
+    EXPECT_FALSE(loadCompressed(path, loaded));
+    EXPECT_TRUE(loaded.empty());
+    EXPECT_FALSE(loadCompressed(path + ".missing", loaded));
+    std::remove(path.c_str());
+}
+
+TEST(CompressedSnapshot, RejectsCorruptHeaderAndKeys)
+{
+    const std::string path = ::testing::TempDir() + "compressed_corrupt.bin";
+    HashMap<int, int> loaded;
+    auto header = [&](BinaryWriter &out, const uint64_t count)
+    {
+        out.writeBytes(COMPRESSED_MAGIC, sizeof(COMPRESSED_MAGIC));
+        out.writePod(COMPRESSED_VERSION);
+        out.writePod(count);
+    };
+
+    // 16-byte file claiming more entries than any table can hold
+    {
+        BinaryWriter out(path);
+        header(out, UINT64_MAX);
+        ASSERT_TRUE(out.close());
+    }
+    EXPECT_FALSE(loadCompressed(path, loaded));
+    EXPECT_TRUE(loaded.empty());
+
+    // Count far beyond what the remaining bytes can encode
+    {
+        BinaryWriter out(path);
+        header(out, uint64_t{1} << 40);
+        out.writeVarint(1);
+        out.writeVarint(0);
+        out.writePod(uint8_t{0});
+        ASSERT_TRUE(out.close());
+    }
+    EXPECT_FALSE(loadCompressed(path, loaded));
+
+    // Two one-entry blocks with the same key
+    {
+        BinaryWriter out(path);
+        header(out, 2);
+        for (int block = 0; block < 2; ++block)
+        {
+            out.writeVarint(1);
+            out.writeVarint(compressed_snapshot_detail::toUnsigned(7));
+            out.writePod(uint8_t{0});
+            out.writeVarint(0);
+            out.writePod(uint8_t{0});
+        }
+        ASSERT_TRUE(out.close());
+    }
+    EXPECT_FALSE(loadCompressed(path, loaded));
+    EXPECT_TRUE(loaded.empty());
+
+    // A key gap that wraps past the largest key
+    {
+        BinaryWriter out(path);
+        header(out, 2);
+        out.writeVarint(2);
+        out.writeVarint(compressed_snapshot_detail::toUnsigned(INT32_MAX - 1));
+        out.writePod(uint8_t{8});
+        out.writePod(uint8_t{1});
+        out.writeVarint(0);
+        out.writePod(uint8_t{0});
+        ASSERT_TRUE(out.close());
+    }
+    EXPECT_FALSE(loadCompressed(path, loaded));
+    EXPECT_TRUE(loaded.empty());
+    std::remove(path.c_str());
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "ContiguousHashMap.h"
+
+TEST(ContiguousHashMap, FreezeInts)
+{
+    HashMap<int, int> map;
+    for (int i = 0; i < 50000; ++i) map.put(i * 16, i);
+    map.remove(16);
+    const auto frozen = ContiguousHashMap<int, int>::freeze(map);
+    EXPECT_EQ(frozen.size(), map.size());
+    for (int i = 0; i < 50000; ++i)
+    {
+        EXPECT_EQ(frozen.get(i * 16), i == 1 ? std::nullopt : std::optional<int>(i));
+        EXPECT_EQ(frozen.get(i * 16 + 1), std::nullopt);
+    }
+}
+
+TEST(ContiguousHashMap, FreezeStringsAndSmallMaps)
+{
+    HashMap<std::string, std::string, 4> map;
+    map.put("Denis", "23");
+    map.put("Anna", "25");
+    const auto small = ContiguousHashMap<std::string, std::string>::freeze(map);
+    EXPECT_EQ(small.size(), 2);
+    EXPECT_EQ(small.get("Denis"), "23");
+    EXPECT_EQ(small.get("Anna"), "25");
+    EXPECT_EQ(small.get("Ivan"), std::nullopt);
+
+    for (int i = 0; i < 1000; ++i) map.put("key" + std::to_string(i), std::to_string(i));
+    const auto frozen = ContiguousHashMap<std::string, std::string>::freeze(map);
+    EXPECT_EQ(frozen.size(), 1002);
+    size_t visited = 0;
+    frozen.forEach([&](const std::string &key, const std::string &value)
+    {
+        EXPECT_EQ(map.get(key), value);
+        ++visited;
+    });
+    EXPECT_EQ(visited, 1002);
+}
+
+TEST(ContiguousHashMap, Empty)
+{
+    HashMap<int, int> map;
+    map.put(1, 1);
+    map.clear();
+    const auto frozen = ContiguousHashMap<int, int>::freeze(map);
+    EXPECT_TRUE(frozen.empty());
+    EXPECT_EQ(frozen.get(1), std::nullopt);
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "DurableHashMap.h"
+
+namespace
+{
+    std::string freshDir(const std::string &name)
+    {
+        const std::string dir = ::testing::TempDir() + name;
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        return dir;
+    }
+}
+
+TEST(DurableHashMap, Reopen)
+{
+    const std::string dir = freshDir("durable_reopen");
+    {
+        DurableHashMap<std::string, int> map;
+        ASSERT_TRUE(map.open(dir));
+        map.put("Denis", 23);
+        map.put("Anna", 25);
+        map.put("Denis", 27);
+        EXPECT_TRUE(map.remove("Anna"));
+        EXPECT_FALSE(map.remove("ghost"));
+        EXPECT_TRUE(map.ok());
+    }
+    DurableHashMap<std::string, int> map;
+    ASSERT_TRUE(map.open(dir));
+    EXPECT_EQ(map.size(), 1);
+    EXPECT_EQ(map.get("Denis"), 27);
+    EXPECT_EQ(map.get("Anna"), std::nullopt);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(DurableHashMap, CompactAndReopen)
+{
+    const std::string dir = freshDir("durable_compact");
+    {
+        DurableHashMap<int, int> map;
+        ASSERT_TRUE(map.open(dir, {Durability::Batched, 16, 0}));
+        for (int i = 0; i < 1000; ++i) map.put(i, i);
+        EXPECT_GT(map.logSize(), 0);
+        ASSERT_TRUE(map.compact());
+        EXPECT_EQ(map.logSize(), 0);
+        for (int i = 0; i < 500; ++i) map.remove(i);
+        map.put(5000, 5);
+    }
+    DurableHashMap<int, int> map;
+    ASSERT_TRUE(map.open(dir));
+    EXPECT_EQ(map.size(), 501);
+    EXPECT_EQ(map.get(10), std::nullopt);
+    EXPECT_EQ(map.get(700), 700);
+    EXPECT_EQ(map.get(5000), 5);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(DurableHashMap, AutomaticCompaction)
+{
+    const std::string dir = freshDir("durable_auto");
+    DurableHashMap<int, int> map;
+    ASSERT_TRUE(map.open(dir, {Durability::None, 8, 1024}));
+    for (int i = 0; i < 1000; ++i) map.put(i, i);
+    EXPECT_LT(map.logSize(), 1024);
+    EXPECT_TRUE(std::filesystem::exists(dir + "/snapshot"));
+    map.close();
+    ASSERT_TRUE(map.open(dir));
+    EXPECT_EQ(map.size(), 1000);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(DurableHashMap, TornTail)
+{
+    const std::string dir = freshDir("durable_torn");
+    {
+        DurableHashMap<int, int> map;
+        ASSERT_TRUE(map.open(dir));
+        map.put(1, 10);
+        map.put(2, 20);
+    }
+    const std::string log = dir + "/wal";
+    const auto full = std::filesystem::file_size(log);
+    std::filesystem::resize_file(log, full - 1);
+    {
+        DurableHashMap<int, int> map;
+        ASSERT_TRUE(map.open(dir));
+        EXPECT_EQ(map.get(1), 10);
+        EXPECT_EQ(map.get(2), std::nullopt);
+        map.put(3, 30);
+    }
+    DurableHashMap<int, int> map;
+    ASSERT_TRUE(map.open(dir));
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.get(3), 30);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(DurableHashMap, CrashWithoutClose)
+{
+    const std::string dir = freshDir("durable_crash");
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+    {
+        auto *map = new DurableHashMap<int, int>();
+        if (!map->open(dir, {Durability::Always, 1, 0})) _exit(1);
+        for (int i = 0; i < 100; ++i) map->put(i, i * 2);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    DurableHashMap<int, int> map;
+    ASSERT_TRUE(map.open(dir));
+    EXPECT_EQ(map.size(), 100);
+    EXPECT_EQ(map.get(99), 198);
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "FilteredHashMap.h"
+
+TEST(FilteredHashMap, StaleKeysAfterResizeRebuild)
+{
+    // 16 buckets, the table grows on the 13th key
+    FilteredHashMap<int, std::string> map;
+    for (int i = 0; i < 12; ++i) map.put(i, std::to_string(i));
+    EXPECT_TRUE(map.remove(3));
+    EXPECT_TRUE(map.remove(5));
+    EXPECT_FALSE(map.remove(5));
+    EXPECT_EQ(map.staleKeys(), 2);
+
+    // Updates and inserts that do not grow the table keep the stale bits
+    map.put(0, "zero");
+    map.put(12, "12");
+    map.put(13, "13");
+    EXPECT_EQ(map.staleKeys(), 2);
+
+    // The resize rebuilds the filter from the live keys only
+    map.put(14, "14");
+    map.put(15, "15");
+    EXPECT_EQ(map.staleKeys(), 0);
+    EXPECT_EQ(map.get(3), std::nullopt);
+    EXPECT_EQ(map.get(5), std::nullopt);
+    EXPECT_EQ(map.get(0), "zero");
+    for (int i = 12; i < 16; ++i) EXPECT_EQ(map.get(i), std::to_string(i));
+
+    EXPECT_TRUE(map.remove(0));
+    EXPECT_EQ(map.staleKeys(), 1);
+    map.rebuildFilter();
+    EXPECT_EQ(map.staleKeys(), 0);
+    EXPECT_TRUE(map.remove(1));
+    map.clear();
+    EXPECT_EQ(map.staleKeys(), 0);
+    EXPECT_EQ(map.get(2), std::nullopt);
+}
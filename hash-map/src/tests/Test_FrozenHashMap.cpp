@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "FrozenHashMap.h"
+
+TEST(FrozenHashMap, FreezeInts)
+{
+    HashMap<int, int> map;
+    for (int i = 0; i < 100000; ++i) map.put(i * 3, i);
+    const auto frozen = FrozenHashMap<int, int>::freeze(map).value();
+    EXPECT_EQ(frozen.size(), map.size());
+    for (int i = 0; i < 100000; ++i)
+    {
+        EXPECT_EQ(frozen.get(i * 3), i);
+        EXPECT_EQ(frozen.get(i * 3 + 1), std::nullopt);
+    }
+    // The source map is untouched
+    EXPECT_EQ(map.get(300), 100);
+}
+
+TEST(FrozenHashMap, FreezeStringsAndSmallMaps)
+{
+    HashMap<std::string, std::string, 4> map;
+    map.put("Denis", "23");
+    map.put("", "empty");
+    const auto small = FrozenHashMap<std::string, std::string>::freeze(map).value();
+    EXPECT_EQ(small.size(), 2);
+    EXPECT_EQ(small.get("Denis"), "23");
+    EXPECT_EQ(small.get(""), "empty");
+    EXPECT_EQ(small.get("Anna"), std::nullopt);
+
+    for (int i = 0; i < 5000; ++i) map.put("key" + std::to_string(i), std::to_string(i));
+    const auto frozen = FrozenHashMap<std::string, std::string>::freeze(map).value();
+    EXPECT_EQ(frozen.size(), 5002);
+    size_t visited = 0;
+    frozen.forEach([&](const std::string &key, const std::string &value)
+    {
+        EXPECT_EQ(map.get(key), value);
+        ++visited;
+    });
+    EXPECT_EQ(visited, 5002);
+}
+
+TEST(FrozenHashMap, Empty)
+{
+    const HashMap<int, int> map;
+    const auto frozen = FrozenHashMap<int, int>::freeze(map).value();
+    EXPECT_TRUE(frozen.empty());
+    EXPECT_EQ(frozen.get(0), std::nullopt);
+    const FrozenHashMap<int, int> unfrozen;
+    EXPECT_EQ(unfrozen.get(1), std::nullopt);
+}
+
+namespace
+{
+    struct Colliding
+    {
+        int id;
+
+        bool operator==(const Colliding &other) const = default;
+    };
+}
+
+template <>
+struct std::hash<Colliding>
+{
+    size_t operator()(const Colliding &key) const
+    {
+        // 5 and 6 share a hash, every other key is distinct
+        return key.id == 6 ? 5 : key.id;
+    }
+};
+
+TEST(FrozenHashMap, EqualHashesFail)
+{
+    HashMap<Colliding, int> map;
+    for (int i = 0; i < 100; ++i) map.put(Colliding{i}, i);
+    EXPECT_EQ(map.get(Colliding{6}), 6);
+    EXPECT_FALSE((FrozenHashMap<Colliding, int>::freeze(map).has_value()));
+
+    map.remove(Colliding{6});
+    const auto frozen = FrozenHashMap<Colliding, int>::freeze(map);
+    ASSERT_TRUE(frozen.has_value());
+    EXPECT_EQ(frozen->get(Colliding{5}), 5);
+    EXPECT_EQ(frozen->get(Colliding{6}), std::nullopt);
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "GroupHashMap.h"
+#include "support/AllocCounter.h"
+
+namespace
+{
+    template<typename K, typename V>
+    size_t visited(const GroupHashMap<K, V> &map)
+    {
+        size_t n = 0;
+        map.forEach([&](const K &, const V &) { ++n; });
+        return n;
+    }
+}
+
+TEST(GroupHashMap, RemoveRefillsFromOverflow)
+{
+    // Identity hash, 4 groups: 0, 4, ..., 24 fill group 0, 28 and 32 overflow
+    GroupHashMap<int, int> map;
+    for (int key = 0; key <= 32; key += 4) map.put(key, key);
+
+    // A slot freed in a full group is refilled from the overflow chain
+    EXPECT_TRUE(map.remove(0));
+    EXPECT_EQ(visited(map), 8);
+    for (int key = 4; key <= 32; key += 4) EXPECT_EQ(map.get(key), key);
+
+    // The last overflow node moves into the group and OVERFLOWED is cleared
+    EXPECT_TRUE(map.remove(4));
+    EXPECT_EQ(visited(map), 7);
+    for (int key = 8; key <= 32; key += 4) EXPECT_EQ(map.get(key), key);
+
+    // With the flag cleared the next remove packs the slots
+    EXPECT_TRUE(map.remove(8));
+    EXPECT_EQ(map.get(8), std::nullopt);
+    EXPECT_EQ(visited(map), 6);
+
+    // Overflow again, then empty the chain from its own side
+    map.put(36, 36);
+    map.put(40, 40);
+    EXPECT_EQ(map.get(40), 40);
+    EXPECT_TRUE(map.remove(40));
+    EXPECT_FALSE(map.remove(40));
+    EXPECT_TRUE(map.remove(12));
+    EXPECT_EQ(visited(map), 6);
+    for (const int key : {16, 20, 24, 28, 32, 36}) EXPECT_EQ(map.get(key), key);
+}
+
+TEST(GroupHashMap, FindPointersSurviveGrowth)
+{
+    GroupHashMap<int, int> map;
+    EXPECT_EQ(map.find(42), nullptr);
+    map.put(42, 1);
+    int *value = map.find(42);
+    ASSERT_NE(value, nullptr);
+    for (int i = 0; i < 10000; ++i) map.put(i * 3 + 1, i);
+    EXPECT_EQ(map.find(42), value);
+    *value = 5;
+    EXPECT_EQ(map.get(42), 5);
+}
+
+TEST(GroupHashMap, ResetFreesOverflowOfEmptiedMap)
+{
+    const size_t live = alloc_counter::liveBytes();
+    {
+        // Identity hash, 4 groups: 0, 4, ..., 28 fill group 0 and overflow
+        GroupHashMap<int, int> map;
+        for (int key = 0; key <= 28; key += 4) map.put(key, key);
+        for (int key = 0; key <= 28; key += 4) EXPECT_TRUE(map.remove(key));
+        EXPECT_TRUE(map.empty());
+
+        // reset() of the emptied map frees the overflow array, the next
+        // overflow allocates a fresh one for the new capacity
+        map.reset();
+        for (int key = 0; key <= 28; key += 4) map.put(key, -key);
+        for (int key = 0; key <= 28; key += 4) EXPECT_EQ(map.get(key), -key);
+        for (int key = 0; key <= 28; key += 4) EXPECT_TRUE(map.remove(key));
+    }
+    EXPECT_EQ(alloc_counter::liveBytes(), live);
+}
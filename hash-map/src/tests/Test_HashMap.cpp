@@ -1,13 +1,15 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
 #include "HashMap.h"
 
-template<typename K, typename V>
-class Test_HashMap : public HashMap<K, V>
+template<typename K, typename V, size_t N = 0>
+class Test_HashMap : public HashMap<K, V, N>
 {
 public:
-    using HashMap<K, V>::getCapacity;
-    using HashMap<K, V>::getLoadFactor;
-    using HashMap<K, V>::getThreshold;
+    using HashMap<K, V, N>::getCapacity;
+    using HashMap<K, V, N>::getLoadFactor;
+    using HashMap<K, V, N>::getThreshold;
 };
 
 TEST(HashMap, PutGet)
@@ -143,3 +145,179 @@ TEST(HashMap, ManyInserts)
     }
 }
 
+TEST(HashMap, SmallMapInline)
+{
+    Test_HashMap<std::string, int, 4> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.get("ghost"), std::nullopt);
+    EXPECT_FALSE(map.remove("ghost"));
+    map.put("a", 1);
+    map.put("b", 2);
+    map.put("c", 3);
+    map.put("b", 20);
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(map.get("a"), 1);
+    EXPECT_EQ(map.get("b"), 20);
+    EXPECT_EQ(map.get("c"), 3);
+    ASSERT_TRUE(map.remove("a"));
+    EXPECT_EQ(map.get("a"), std::nullopt);
+    EXPECT_EQ(map.get("c"), 3);
+    EXPECT_EQ(map.size(), 2);
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.get("b"), std::nullopt);
+}
+
+TEST(HashMap, SmallMapSpill)
+{
+    Test_HashMap<int, int, 8> map;
+    for (int i = 0; i < 8; ++i) map.put(i, i * 10);
+    EXPECT_EQ(map.size(), 8);
+    for (int i = 8; i < 100; ++i) map.put(i, i * 10);
+    EXPECT_EQ(map.size(), 100);
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(map.get(i), i * 10);
+    EXPECT_EQ(map.getCapacity(), 256);
+    ASSERT_TRUE(map.remove(3));
+    EXPECT_EQ(map.get(3), std::nullopt);
+    map.reset();
+    EXPECT_EQ(map.size(), 0);
+    EXPECT_EQ(map.getCapacity(), 16);
+    map.put(1, 1);
+    EXPECT_EQ(map.get(1), 1);
+}
+
+TEST(HashMap, SmallMapLargeInline)
+{
+    Test_HashMap<int, int, 20> map;
+    for (int i = 0; i < 21; ++i) map.put(i, i);
+    EXPECT_EQ(map.size(), 21);
+    EXPECT_EQ(map.getCapacity(), 32);
+    for (int i = 0; i < 21; ++i) EXPECT_EQ(map.get(i), i);
+}
+
+TEST(HashMap, EmptyMapLookups)
+{
+    Test_HashMap<std::string, int> map;
+    EXPECT_EQ(map.get("ghost"), std::nullopt);
+    EXPECT_FALSE(map.remove("ghost"));
+    map.clear();
+    map.reset();
+    EXPECT_EQ(map.getCapacity(), 16);
+    map.put("some", 1);
+    EXPECT_EQ(map.get("some"), 1);
+}
+
+TEST(HashMap, Move)
+{
+    Test_HashMap<int, int> map;
+    for (int i = 0; i < 100; ++i) map.put(i, i);
+    Test_HashMap<int, int> moved(std::move(map));
+    EXPECT_EQ(moved.size(), 100);
+    EXPECT_EQ(moved.get(42), 42);
+    EXPECT_EQ(moved.getCapacity(), 256);
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.getCapacity(), 16);
+    EXPECT_EQ(map.get(42), std::nullopt);
+
+    map.put(7, 70);
+    map = std::move(moved);
+    EXPECT_EQ(map.size(), 100);
+    EXPECT_EQ(map.get(7), 7);
+    EXPECT_TRUE(moved.empty());
+    moved.put(1, 1);
+    EXPECT_EQ(moved.get(1), 1);
+}
+
+TEST(HashMap, MoveSmallMap)
+{
+    Test_HashMap<std::string, std::string, 4> map;
+    map.setChainOrder(ChainOrder::Transpose);
+    map.put("a", "1");
+    map.put("b", "2");
+    Test_HashMap<std::string, std::string, 4> moved(std::move(map));
+    EXPECT_EQ(moved.size(), 2);
+    EXPECT_EQ(moved.get("b"), "2");
+    EXPECT_EQ(moved.getChainOrder(), ChainOrder::Transpose);
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.getChainOrder(), ChainOrder::Unordered);
+    EXPECT_EQ(map.get("a"), std::nullopt);
+}
+
+/// Keys of bucket @p index, head first
+template<typename K, typename V>
+std::vector<K> chainOf(const HashMap<K, V> &map, const size_t index)
+{
+    std::vector<K> keys;
+    for (const Node<K, V> *e = HashMapInternals<K, V, 0>::buckets(map)[index]; e; e = e->next)
+    {
+        keys.push_back(e->key);
+    }
+    return keys;
+}
+
+TEST(HashMap, ChainOrderMoveToFront)
+{
+    HashMap<int, int> map;
+    EXPECT_EQ(map.getChainOrder(), ChainOrder::Unordered);
+    for (const int key : {1, 17, 33, 49}) map.put(key, key);
+    EXPECT_EQ(map.get(1), 1);
+    EXPECT_EQ(chainOf(map, 1), (std::vector<int>{49, 33, 17, 1}));
+
+    map.setChainOrder(ChainOrder::MoveToFront);
+    EXPECT_EQ(map.get(1), 1);
+    EXPECT_EQ(chainOf(map, 1), (std::vector<int>{1, 49, 33, 17}));
+    EXPECT_EQ(map.get(33), 33);
+    EXPECT_EQ(chainOf(map, 1), (std::vector<int>{33, 1, 49, 17}));
+    EXPECT_EQ(map.get(65), std::nullopt);
+    EXPECT_TRUE(map.remove(1));
+    EXPECT_EQ(map.get(17), 17);
+    EXPECT_EQ(chainOf(map, 1), (std::vector<int>{17, 33, 49}));
+
+    HashMap<int, int> moved(std::move(map));
+    EXPECT_EQ(moved.getChainOrder(), ChainOrder::MoveToFront);
+    EXPECT_EQ(map.getChainOrder(), ChainOrder::Unordered);
+}
+
+TEST(HashMap, ChainOrderTranspose)
+{
+    HashMap<int, int> map;
+    map.setChainOrder(ChainOrder::Transpose);
+    for (const int key : {1, 17, 33, 49}) map.put(key, key);
+    EXPECT_EQ(map.get(1), 1);
+    EXPECT_EQ(chainOf(map, 1), (std::vector<int>{49, 33, 1, 17}));
+    EXPECT_EQ(map.get(1), 1);
+    EXPECT_EQ(map.get(1), 1);
+    EXPECT_EQ(chainOf(map, 1), (std::vector<int>{1, 49, 33, 17}));
+    EXPECT_EQ(map.get(1), 1);
+    EXPECT_EQ(chainOf(map, 1), (std::vector<int>{1, 49, 33, 17}));
+    for (int i = 0; i < 1000; ++i) map.put(i * 16 + 1, i);
+    for (int i = 4; i < 1000; ++i) EXPECT_EQ(map.get(i * 16 + 1), i);
+    EXPECT_EQ(map.size(), 1000);
+}
+
+TEST(HashMap, ChainOrderSortedByHash)
+{
+    HashMap<int, int> map;
+    for (const int key : {49, 1, 33, 17}) map.put(key, key);
+    map.setChainOrder(ChainOrder::SortedByHash);
+    EXPECT_EQ(chainOf(map, 1), (std::vector<int>{1, 17, 33, 49}));
+    map.put(25 * 16 + 1, 0);
+    map.put(9, 9);
+    EXPECT_EQ(chainOf(map, 1), (std::vector<int>{1, 17, 33, 49, 401}));
+    EXPECT_EQ(map.get(33), 33);
+    EXPECT_EQ(map.get(41), std::nullopt);
+    EXPECT_FALSE(map.remove(41));
+    EXPECT_TRUE(map.remove(33));
+    EXPECT_EQ(chainOf(map, 1), (std::vector<int>{1, 17, 49, 401}));
+
+    // Growth splits chains without reversing them
+    for (int i = 0; i < 1000; ++i) map.put(i * 64 + 1, i);
+    const size_t capacity = HashMapInternals<int, int, 0>::capacity(map);
+    for (size_t b = 0; b < capacity; ++b)
+    {
+        const std::vector<int> chain = chainOf(map, b);
+        EXPECT_TRUE(std::is_sorted(chain.begin(), chain.end()));
+    }
+    for (int i = 0; i < 1000; ++i) EXPECT_EQ(map.get(i * 64 + 1), i);
+    EXPECT_EQ(map.get(17), 17);
+}
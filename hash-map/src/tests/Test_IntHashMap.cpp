@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include "IntHashMap.h"
+#include "support/AllocCounter.h"
+
+static_assert(std::is_same_v<AutoHashMap<int, int>, IntHashMap<int, int>>);
+static_assert(std::is_same_v<AutoHashMap<uint64_t, double>, IntHashMap<uint64_t, double>>);
+static_assert(std::is_same_v<AutoHashMap<std::string, int>, HashMap<std::string, int>>);
+
+TEST(IntHashMap, PutGetRemove)
+{
+    IntHashMap<int, int> map;
+    EXPECT_EQ(map.get(1), std::nullopt);
+    EXPECT_FALSE(map.remove(1));
+    for (int i = 0; i < 1000; ++i) map.put(i, i * 2);
+    EXPECT_EQ(map.size(), 1000);
+    map.put(5, 55);
+    EXPECT_EQ(map.size(), 1000);
+    EXPECT_EQ(map.get(5), 55);
+    EXPECT_EQ(map.get(999), 1998);
+    EXPECT_EQ(map.get(1000), std::nullopt);
+    EXPECT_TRUE(map.remove(5));
+    EXPECT_FALSE(map.remove(5));
+    EXPECT_EQ(map.get(5), std::nullopt);
+    EXPECT_EQ(map.size(), 999);
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.get(1), std::nullopt);
+}
+
+TEST(IntHashMap, SentinelKey)
+{
+    IntHashMap<int, int> map;
+    const int sentinel = std::numeric_limits<int>::max();
+    map.put(sentinel, 1);
+    map.put(-1, 2);
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.get(sentinel), 1);
+    size_t visited = 0;
+    map.forEach([&](const int, const int) { ++visited; });
+    EXPECT_EQ(visited, 2);
+    EXPECT_TRUE(map.remove(sentinel));
+    EXPECT_EQ(map.get(sentinel), std::nullopt);
+    EXPECT_EQ(map.size(), 1);
+}
+
+TEST(IntHashMap, RandomAgainstReference)
+{
+    std::mt19937_64 rng(42);
+    IntHashMap<uint64_t, std::string> map;
+    std::unordered_map<uint64_t, std::string> reference;
+    for (int step = 0; step < 200000; ++step)
+    {
+        // Small key range, so removes hit long probe sequences
+        const uint64_t key = rng() % 5000 * 1024;
+        if (rng() % 3 == 0)
+        {
+            EXPECT_EQ(map.remove(key), reference.erase(key) == 1);
+        }
+        else
+        {
+            const std::string value = std::to_string(step);
+            map.put(key, value);
+            reference[key] = value;
+        }
+    }
+    EXPECT_EQ(map.size(), reference.size());
+    for (const auto &[key, value] : reference) EXPECT_EQ(map.get(key), value);
+    size_t visited = 0;
+    map.forEach([&](const uint64_t key, const std::string &value)
+    {
+        EXPECT_EQ(reference.at(key), value);
+        ++visited;
+    });
+    EXPECT_EQ(visited, reference.size());
+}
+
+TEST(IntHashMap, MoveAndReset)
+{
+    IntHashMap<int, std::string> map;
+    for (int i = 0; i < 100; ++i) map.put(i, std::to_string(i));
+    IntHashMap<int, std::string> moved(std::move(map));
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(moved.get(42), "42");
+    map = std::move(moved);
+    EXPECT_EQ(map.size(), 100);
+    map.reset();
+    EXPECT_TRUE(map.empty());
+    map.put(1, "one");
+    EXPECT_EQ(map.get(1), "one");
+}
+
+TEST(IntHashMap, FlatStorage)
+{
+    IntHashMap<int, int> map;
+    AllocScope scope;
+    for (int i = 0; i < 100000; ++i) map.put(i, i);
+    // Two arrays per table size: 16, 32, ..., 262144 slots
+    EXPECT_EQ(scope.allocations(), 2 * 15);
+    AllocScope lookups;
+    for (int i = 0; i < 100000; ++i) EXPECT_EQ(map.get(i), i);
+    for (int i = 0; i < 100000; i += 2) map.remove(i);
+    EXPECT_EQ(lookups.allocations(), 0);
+}
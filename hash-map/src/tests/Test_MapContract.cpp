@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include "CachedHashMap.h"
+#include "ColumnarHashMap.h"
+#include "FilteredHashMap.h"
+#include "GroupHashMap.h"
+#include "OrderedHashMap.h"
+#include "TaggedHashMap.h"
+
+// Behaviour shared by every map that mirrors the HashMap API; engine
+// specific behaviour is tested in the engine's own file.
+
+template <template <typename, typename> class M>
+struct Engine
+{
+    template <typename K, typename V>
+    using Map = M<K, V>;
+};
+
+template <typename E>
+class MapContract : public ::testing::Test {};
+
+using ContractEngines = ::testing::Types<
+    Engine<ColumnarHashMap>,
+    Engine<TaggedHashMap>,
+    Engine<GroupHashMap>,
+    Engine<FilteredHashMap>,
+    Engine<CachedHashMap>,
+    Engine<OrderedHashMap>>;
+TYPED_TEST_SUITE(MapContract, ContractEngines);
+
+TYPED_TEST(MapContract, PutGetRemove)
+{
+    using Map = typename TypeParam::template Map<std::string, int>;
+    Map map;
+    EXPECT_EQ(map.get("a"), std::nullopt);
+    EXPECT_FALSE(map.remove("a"));
+    for (int i = 0; i < 1000; ++i) map.put("key-" + std::to_string(i), i);
+    map.put("key-0", 7);
+    EXPECT_EQ(map.size(), 1000);
+    EXPECT_EQ(map.get("key-0"), 7);
+    EXPECT_EQ(map.get("key-999"), 999);
+    EXPECT_EQ(map.get("key-1000"), std::nullopt);
+    EXPECT_TRUE(map.remove("key-500"));
+    EXPECT_FALSE(map.remove("key-500"));
+    EXPECT_EQ(map.get("key-500"), std::nullopt);
+    EXPECT_EQ(map.size(), 999);
+
+    Map moved = std::move(map);
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.get("key-1"), std::nullopt);
+    EXPECT_EQ(moved.get("key-1"), 1);
+
+    moved.clear();
+    EXPECT_TRUE(moved.empty());
+    EXPECT_EQ(moved.get("key-1"), std::nullopt);
+    moved.put("b", 3);
+    EXPECT_EQ(moved.get("b"), 3);
+    moved.reset();
+    EXPECT_EQ(moved.get("b"), std::nullopt);
+    moved.put("c", 4);
+    EXPECT_EQ(moved.get("c"), 4);
+}
+
+TYPED_TEST(MapContract, RandomAgainstReference)
+{
+    std::mt19937 rng(13);
+    typename TypeParam::template Map<int, std::string> map;
+    std::unordered_map<int, std::string> reference;
+    for (int step = 0; step < 100000; ++step)
+    {
+        // Multiples of 64 share low bits: long chains, probe runs and overflows
+        const int key = static_cast<int>(rng() % 2000) * 64;
+        const unsigned op = rng() % 4;
+        if (op == 0)
+        {
+            EXPECT_EQ(map.remove(key), reference.erase(key) == 1);
+        }
+        else if (op == 3)
+        {
+            const auto it = reference.find(key);
+            EXPECT_EQ(map.get(key), it == reference.end() ? std::nullopt : std::optional<std::string>(it->second));
+        }
+        else
+        {
+            map.put(key, std::to_string(step));
+            reference[key] = std::to_string(step);
+        }
+    }
+    EXPECT_EQ(map.size(), reference.size());
+    for (int key = 0; key < 2000 * 64; key += 32)
+    {
+        const auto it = reference.find(key);
+        EXPECT_EQ(map.get(key), it == reference.end() ? std::nullopt : std::optional<std::string>(it->second));
+    }
+    size_t visited = 0;
+    map.forEach([&](const int key, const std::string &value)
+    {
+        EXPECT_EQ(reference.at(key), value);
+        ++visited;
+    });
+    EXPECT_EQ(visited, reference.size());
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include "MappedHashMap.h"
+
+TEST(MappedHashMap, Ints)
+{
+    const std::string path = ::testing::TempDir() + "mapped_ints.bin";
+    HashMap<int, int> map;
+    for (int i = 0; i < 10000; ++i) map.put(i, i * 10);
+    ASSERT_TRUE((MappedHashMap<int, int>::write(map, path)));
+
+    MappedHashMap<int, int> mapped;
+    ASSERT_TRUE(mapped.open(path));
+    EXPECT_EQ(mapped.size(), 10000);
+    for (int i = 0; i < 10000; ++i) EXPECT_EQ(mapped.get(i), i * 10);
+    EXPECT_EQ(mapped.get(-1), std::nullopt);
+    EXPECT_EQ(mapped.get(10000), std::nullopt);
+    std::remove(path.c_str());
+}
+
+TEST(MappedHashMap, Strings)
+{
+    const std::string path = ::testing::TempDir() + "mapped_strings.bin";
+    HashMap<std::string, std::string, 2> map;
+    map.put("Denis", "23");
+    map.put("Anna", "");
+    map.put("Димитрий", std::string(500, 'x'));
+    ASSERT_TRUE((MappedHashMap<std::string, std::string>::write(map, path)));
+
+    MappedHashMap<std::string, std::string> mapped;
+    ASSERT_TRUE(mapped.open(path));
+    EXPECT_EQ(mapped.size(), 3);
+    EXPECT_EQ(mapped.get("Denis"), "23");
+    EXPECT_EQ(mapped.get("Anna"), "");
+    EXPECT_EQ(mapped.get("Димитрий"), std::string(500, 'x'));
+    EXPECT_EQ(mapped.get("Den"), std::nullopt);
+
+    MappedHashMap<std::string, std::string> moved(std::move(mapped));
+    EXPECT_FALSE(mapped.isOpen());
+    EXPECT_EQ(moved.get("Denis"), "23");
+    std::remove(path.c_str());
+}
+
+TEST(MappedHashMap, EmptyAndInvalid)
+{
+    const std::string path = ::testing::TempDir() + "mapped_empty.bin";
+    HashMap<int, int> map;
+    ASSERT_TRUE((MappedHashMap<int, int>::write(map, path)));
+    MappedHashMap<int, int> mapped;
+    ASSERT_TRUE(mapped.open(path));
+    EXPECT_TRUE(mapped.empty());
+    EXPECT_EQ(mapped.get(1), std::nullopt);
+
+    // Wrong value type changes the node size
+    MappedHashMap<int, double> wrong;
+    EXPECT_FALSE(wrong.open(path));
+    EXPECT_FALSE(wrong.open(path + ".missing"));
+
+    map.put(1, 1);
+    ASSERT_TRUE(map.save(path));
+    EXPECT_FALSE(mapped.open(path));
+    EXPECT_FALSE(mapped.isOpen());
+    std::remove(path.c_str());
+}
+
+namespace
+{
+    uint64_t readWord(const std::string &path, const off_t pos)
+    {
+        uint64_t value = 0;
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        EXPECT_EQ(::pread(fd, &value, sizeof(value), pos), static_cast<ssize_t>(sizeof(value)));
+        ::close(fd);
+        return value;
+    }
+
+    void writeWord(const std::string &path, const off_t pos, const uint64_t value)
+    {
+        const int fd = ::open(path.c_str(), O_WRONLY);
+        EXPECT_EQ(::pwrite(fd, &value, sizeof(value), pos), static_cast<ssize_t>(sizeof(value)));
+        ::close(fd);
+    }
+}
+
+TEST(MappedHashMap, CorruptOffsets)
+{
+    // Header: magic, version, then capacity at byte 8; buckets start at 64
+    constexpr off_t capacity_pos = 8;
+    constexpr off_t buckets_pos = 64;
+    const std::string path = ::testing::TempDir() + "mapped_corrupt.bin";
+    HashMap<int, int> map;
+    for (int i = 0; i < 8; ++i) map.put(i, i * 10);
+    auto rewrite = [&]
+    {
+        ASSERT_TRUE((MappedHashMap<int, int>::write(map, path)));
+    };
+    MappedHashMap<int, int> mapped;
+
+    // A bucket array that would reach past the nodes once the size overflows
+    rewrite();
+    writeWord(path, capacity_pos, uint64_t{1} << 61);
+    EXPECT_FALSE(mapped.open(path));
+    EXPECT_FALSE(mapped.isOpen());
+
+    // A bucket head pointing into the header is a miss, other buckets work
+    rewrite();
+    writeWord(path, buckets_pos + 1 * sizeof(uint64_t), 8);
+    ASSERT_TRUE(mapped.open(path));
+    EXPECT_EQ(mapped.get(1), std::nullopt);
+    EXPECT_EQ(mapped.get(2), 20);
+
+    // A head past the end of the file
+    mapped.close();
+    writeWord(path, buckets_pos + 3 * sizeof(uint64_t), UINT64_MAX - 7);
+    ASSERT_TRUE(mapped.open(path));
+    EXPECT_EQ(mapped.get(3), std::nullopt);
+
+    // A node linked to itself ends the walk instead of looping
+    mapped.close();
+    const uint64_t node = readWord(path, buckets_pos + 2 * sizeof(uint64_t));
+    writeWord(path, static_cast<off_t>(node + sizeof(uint64_t)), node);
+    ASSERT_TRUE(mapped.open(path));
+    EXPECT_EQ(mapped.get(2), 20);
+    EXPECT_EQ(mapped.get(2 + 16), std::nullopt);
+    mapped.close();
+    std::remove(path.c_str());
+}
+
+TEST(MappedHashMap, CorruptStringSlots)
+{
+    const std::string path = ::testing::TempDir() + "mapped_corrupt_strings.bin";
+    HashMap<std::string, std::string> map;
+    map.put("Denis", "23");
+    ASSERT_TRUE((MappedHashMap<std::string, std::string>::write(map, path)));
+
+    // Single node right after 16 buckets: hash, next, key (offset, length), value
+    constexpr off_t node_pos = 64 + 16 * sizeof(uint64_t);
+    MappedHashMap<std::string, std::string> mapped;
+    writeWord(path, node_pos + 5 * sizeof(uint64_t), UINT64_MAX);
+    ASSERT_TRUE(mapped.open(path));
+    EXPECT_EQ(mapped.get("Denis"), std::nullopt);
+
+    // A key outside the data section fails the hash check of open()
+    mapped.close();
+    writeWord(path, node_pos + 2 * sizeof(uint64_t), 0);
+    EXPECT_FALSE(mapped.open(path));
+    std::remove(path.c_str());
+}
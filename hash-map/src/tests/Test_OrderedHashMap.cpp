@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "OrderedHashMap.h"
+
+namespace
+{
+    template <typename K, typename V>
+    std::vector<K> keysInOrder(const OrderedHashMap<K, V> &map)
+    {
+        std::vector<K> keys;
+        map.forEach([&](const K &key, const V &) { keys.push_back(key); });
+        return keys;
+    }
+}
+
+TEST(OrderedHashMap, InsertionOrder)
+{
+    OrderedHashMap<std::string, int> map;
+    map.put("b", 2);
+    map.put("c", 3);
+    map.put("a", 1);
+    map.put("b", 20);
+    EXPECT_EQ(keysInOrder(map), (std::vector<std::string>{"b", "c", "a"}));
+    EXPECT_EQ(map.get("b"), 20);
+
+    EXPECT_TRUE(map.remove("c"));
+    EXPECT_FALSE(map.remove("c"));
+    map.put("d", 4);
+    map.put("c", 30);
+    EXPECT_EQ(keysInOrder(map), (std::vector<std::string>{"b", "a", "d", "c"}));
+    EXPECT_EQ(map.size(), 4);
+    EXPECT_EQ(map.get("c"), 30);
+    EXPECT_EQ(map.get("z"), std::nullopt);
+}
+
+TEST(OrderedHashMap, OrderSurvivesRebuilds)
+{
+    OrderedHashMap<int, int> map;
+    for (int i = 0; i < 100000; ++i) map.put(i, i);
+    for (int i = 0; i < 100000; i += 2) map.remove(i);
+    for (int i = 100000; i < 200000; ++i) map.put(i, i);
+    const std::vector<int> keys = keysInOrder(map);
+    ASSERT_EQ(keys.size(), 150000);
+    for (size_t i = 1; i < keys.size(); ++i) EXPECT_LT(keys[i - 1], keys[i]);
+    EXPECT_EQ(map.get(1), 1);
+    EXPECT_EQ(map.get(2), std::nullopt);
+}
+
+TEST(OrderedHashMap, ClearAndReset)
+{
+    OrderedHashMap<int, std::string> map;
+    for (int i = 0; i < 100; ++i) map.put(i, std::to_string(i));
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.get(1), std::nullopt);
+    map.put(5, "five");
+    EXPECT_EQ(keysInOrder(map), std::vector<int>{5});
+    map.reset();
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.remove(5));
+    map.put(6, "six");
+    EXPECT_EQ(map.get(6), "six");
+}
+
+TEST(OrderedHashMap, StridedIntegerKeys)
+{
+    // Identity hashes with equal low 16 bits form one probe run unless mixed
+    OrderedHashMap<int64_t, int64_t> map;
+    for (int64_t i = 0; i < 100000; ++i) map.put(i << 16, i);
+    EXPECT_EQ(map.size(), 100000);
+    for (int64_t i = 0; i < 100000; ++i) EXPECT_EQ(map.get(i << 16), i);
+    EXPECT_EQ(map.get(1), std::nullopt);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include "PersistentHashMap.h"
+
+namespace
+{
+    std::string freshPath(const std::string &name)
+    {
+        const std::string path = ::testing::TempDir() + name;
+        std::remove(path.c_str());
+        std::remove((path + ".idx").c_str());
+        return path;
+    }
+
+    void removeFiles(const std::string &path)
+    {
+        std::remove(path.c_str());
+        std::remove((path + ".idx").c_str());
+    }
+}
+
+TEST(PersistentHashMap, PutGetRemove)
+{
+    const std::string path = freshPath("persistent_basic.bin");
+    PersistentHashMap<int, int> map;
+    ASSERT_TRUE(map.open(path, 4));
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.get(1), std::nullopt);
+    map.put(1, 10);
+    map.put(17, 170);
+    map.put(1, 11);
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.get(1), 11);
+    EXPECT_EQ(map.get(17), 170);
+    EXPECT_TRUE(map.remove(1));
+    EXPECT_FALSE(map.remove(1));
+    EXPECT_EQ(map.get(1), std::nullopt);
+    EXPECT_EQ(map.size(), 1);
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.get(17), std::nullopt);
+    EXPECT_TRUE(map.ok());
+    map.close();
+    removeFiles(path);
+}
+
+TEST(PersistentHashMap, GrowthAndReopen)
+{
+    const std::string path = freshPath("persistent_growth.bin");
+    {
+        PersistentHashMap<uint64_t, double> map;
+        ASSERT_TRUE(map.open(path, 8));
+        for (uint64_t i = 0; i < 20000; ++i) map.put(i * 7919, static_cast<double>(i));
+        for (uint64_t i = 0; i < 20000; i += 2) map.remove(i * 7919);
+        // Freed nodes are reused
+        for (uint64_t i = 0; i < 5000; ++i) map.put(i * 7919 + 1, -1.0);
+        ASSERT_TRUE(map.ok());
+    }
+    PersistentHashMap<uint64_t, double> map;
+    ASSERT_TRUE(map.open(path));
+    EXPECT_EQ(map.size(), 15000);
+    for (uint64_t i = 0; i < 20000; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            EXPECT_EQ(map.get(i * 7919), std::nullopt);
+        }
+        else
+        {
+            EXPECT_EQ(map.get(i * 7919), static_cast<double>(i));
+        }
+    }
+    EXPECT_EQ(map.get(4999 * 7919 + 1), -1.0);
+    map.close();
+    removeFiles(path);
+}
+
+TEST(PersistentHashMap, RejectsOtherTypes)
+{
+    const std::string path = freshPath("persistent_types.bin");
+    {
+        PersistentHashMap<int, int> map;
+        ASSERT_TRUE(map.open(path));
+        map.put(1, 1);
+    }
+    PersistentHashMap<int, double> other;
+    EXPECT_FALSE(other.open(path));
+    EXPECT_FALSE(other.ok());
+    other.put(1, 1.0);
+    EXPECT_EQ(other.get(1), std::nullopt);
+    removeFiles(path);
+}
+
+TEST(PersistentHashMap, RecoversInterruptedGrowth)
+{
+    const std::string path = freshPath("persistent_crash.bin");
+    // Header.growing_from follows nine fields of 4 x uint32 and 5 x uint64
+    constexpr off_t growing_from_offset = 56;
+    auto interruptGrowth = [&](const off_t idx_size)
+    {
+        const int fd = ::open(path.c_str(), O_RDWR);
+        ASSERT_GE(fd, 0);
+        const uint64_t old_cap = 16;
+        ASSERT_EQ(::pwrite(fd, &old_cap, sizeof(old_cap), growing_from_offset), sizeof(old_cap));
+        ::close(fd);
+        ASSERT_EQ(::truncate((path + ".idx").c_str(), idx_size), 0);
+    };
+    {
+        PersistentHashMap<int, int> map;
+        ASSERT_TRUE(map.open(path, 4));
+        for (int i = 0; i < 12; ++i) map.put(i * 16, i);
+        map.remove(0);
+        map.remove(16);
+    }
+
+    // Died after doubling the bucket file, before splitting the chains
+    interruptGrowth(32 * sizeof(uint64_t));
+    {
+        PersistentHashMap<int, int> map;
+        ASSERT_TRUE(map.open(path));
+        EXPECT_EQ(map.size(), 10);
+        EXPECT_EQ(map.get(0), std::nullopt);
+        EXPECT_EQ(map.get(16), std::nullopt);
+        for (int i = 2; i < 12; ++i) EXPECT_EQ(map.get(i * 16), i);
+    }
+
+    // Died before the bucket file grew
+    interruptGrowth(16 * sizeof(uint64_t));
+    PersistentHashMap<int, int> map;
+    ASSERT_TRUE(map.open(path));
+    for (int i = 1000; i < 1900; ++i) map.put(i, -i);
+    EXPECT_TRUE(map.ok());
+    EXPECT_EQ(map.size(), 910);
+    for (int i = 2; i < 12; ++i) EXPECT_EQ(map.get(i * 16), i);
+    EXPECT_EQ(map.get(1899), -1899);
+    map.close();
+    removeFiles(path);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "SharedHashMap.h"
+
+namespace
+{
+    std::string uniqueName(const std::string &name)
+    {
+        return "/hashmap-test-" + name + "-" + std::to_string(getpid());
+    }
+}
+
+TEST(SharedHashMap, PutGetRemove)
+{
+    const std::string name = uniqueName("basic");
+    SharedHashMap<int, int> map;
+    ASSERT_TRUE(map.create(name, 4));
+    EXPECT_EQ(map.maxSize(), 4);
+    EXPECT_TRUE(map.put(1, 10));
+    EXPECT_TRUE(map.put(17, 170));
+    EXPECT_TRUE(map.put(1, 11));
+    EXPECT_EQ(map.get(1), 11);
+    EXPECT_EQ(map.get(17), 170);
+    EXPECT_EQ(map.get(2), std::nullopt);
+    EXPECT_TRUE(map.put(2, 20));
+    EXPECT_TRUE(map.put(3, 30));
+    EXPECT_FALSE(map.put(4, 40));
+    EXPECT_EQ(map.size(), 4);
+    EXPECT_TRUE(map.remove(2));
+    EXPECT_FALSE(map.remove(2));
+    EXPECT_TRUE(map.put(4, 40));
+    EXPECT_EQ(map.get(4), 40);
+
+    // Creating the same name twice fails
+    SharedHashMap<int, int> duplicate;
+    EXPECT_FALSE(duplicate.create(name, 4));
+    EXPECT_TRUE((SharedHashMap<int, int>::unlink(name)));
+}
+
+TEST(SharedHashMap, SecondHandleSeesWrites)
+{
+    const std::string name = uniqueName("handles");
+    SharedHashMap<int, double> writer;
+    ASSERT_TRUE(writer.create(name, 1000));
+    SharedHashMap<int, double> reader;
+    ASSERT_TRUE(reader.open(name));
+    writer.put(5, 2.5);
+    EXPECT_EQ(reader.get(5), 2.5);
+    reader.remove(5);
+    EXPECT_EQ(writer.get(5), std::nullopt);
+
+    SharedHashMap<int, int> wrong;
+    EXPECT_FALSE(wrong.open(name));
+    // Same node size and alignment, other types
+    SharedHashMap<int64_t, double> same_layout;
+    EXPECT_FALSE(same_layout.open(name));
+    SharedHashMap<int, int64_t> swapped;
+    EXPECT_FALSE(swapped.open(name));
+    EXPECT_TRUE((SharedHashMap<int, double>::unlink(name)));
+    EXPECT_FALSE(wrong.open(name));
+}
+
+TEST(SharedHashMap, AcrossProcesses)
+{
+    const std::string name = uniqueName("fork");
+    SharedHashMap<int, int> map;
+    ASSERT_TRUE(map.create(name, 20000));
+
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+    {
+        SharedHashMap<int, int> child;
+        if (!child.open(name)) _exit(1);
+        for (int i = 0; i < 10000; i += 2) child.put(i, i * 3);
+        _exit(0);
+    }
+    for (int i = 1; i < 10000; i += 2) map.put(i, i * 3);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    EXPECT_EQ(map.size(), 10000);
+    for (int i = 0; i < 10000; ++i) EXPECT_EQ(map.get(i), i * 3);
+    EXPECT_TRUE((SharedHashMap<int, int>::unlink(name)));
+}
@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdio>
+#include <limits>
+#include <vector>
+#include <unistd.h>
+#include "HashMap.h"
+#include "support/AllocCounter.h"
+
+template<typename K, typename V, size_t N = 0>
+class Test_SnapshotMap : public HashMap<K, V, N>
+{
+public:
+    using HashMap<K, V, N>::getCapacity;
+    using HashMap<K, V, N>::getLoadFactor;
+};
+
+TEST(Snapshot, SaveLoadInts)
+{
+    const std::string path = ::testing::TempDir() + "snapshot_ints.bin";
+    Test_SnapshotMap<int, int> map;
+    for (int i = 0; i < 10000; ++i) map.put(i, i * 10);
+    map.remove(5);
+    ASSERT_TRUE(map.save(path));
+
+    Test_SnapshotMap<int, int> loaded;
+    loaded.put(-1, -1);
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.size(), map.size());
+    EXPECT_EQ(loaded.getCapacity(), map.getCapacity());
+    EXPECT_EQ(loaded.get(-1), std::nullopt);
+    EXPECT_EQ(loaded.get(5), std::nullopt);
+    for (int i = 0; i < 10000; ++i)
+    {
+        if (i != 5)
+        {
+            EXPECT_EQ(loaded.get(i), i * 10);
+        }
+    }
+    loaded.put(20000, 1);
+    EXPECT_EQ(loaded.get(20000), 1);
+    std::remove(path.c_str());
+}
+
+TEST(Snapshot, SaveLoadStrings)
+{
+    const std::string path = ::testing::TempDir() + "snapshot_strings.bin";
+    HashMap<std::string, std::string> map;
+    map.put("Denis", "23");
+    map.put("", "empty key");
+    map.put("Димитрий", std::string(1000, 'x'));
+    ASSERT_TRUE(map.save(path));
+
+    HashMap<std::string, std::string> loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.size(), 3);
+    EXPECT_EQ(loaded.get("Denis"), "23");
+    EXPECT_EQ(loaded.get(""), "empty key");
+    EXPECT_EQ(loaded.get("Димитрий"), std::string(1000, 'x'));
+    std::remove(path.c_str());
+}
+
+TEST(Snapshot, SaveLoadEmptyAndSmall)
+{
+    const std::string path = ::testing::TempDir() + "snapshot_small.bin";
+    HashMap<int, int> empty;
+    ASSERT_TRUE(empty.save(path));
+    HashMap<int, int> loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_TRUE(loaded.empty());
+
+    HashMap<int, int, 4> small;
+    small.put(1, 10);
+    small.put(2, 20);
+    ASSERT_TRUE(small.save(path));
+    HashMap<int, int, 4> small_loaded;
+    ASSERT_TRUE(small_loaded.load(path));
+    EXPECT_EQ(small_loaded.size(), 2);
+    EXPECT_EQ(small_loaded.get(2), 20);
+
+    // Snapshots are independent of the small-map mode
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.get(1), 10);
+    std::remove(path.c_str());
+}
+
+TEST(Snapshot, LoadDoesNotResize)
+{
+    const std::string path = ::testing::TempDir() + "snapshot_presized.bin";
+    HashMap<int, int> map;
+    for (int i = 0; i < 5000; ++i) map.put(i, i);
+    ASSERT_TRUE(map.save(path));
+
+    HashMap<int, int> loaded;
+    AllocScope scope;
+    ASSERT_TRUE(loaded.load(path));
+    // Reader buffer, one bucket array, one node per entry
+    EXPECT_EQ(scope.allocations(), 2 + 5000);
+    std::remove(path.c_str());
+}
+
+TEST(Snapshot, TruncatedSnapshot)
+{
+    const std::string path = ::testing::TempDir() + "snapshot_truncated.bin";
+    HashMap<int, int> map;
+    for (int i = 0; i < 100; ++i) map.put(i, i);
+    ASSERT_TRUE(map.save(path));
+    std::FILE *f = std::fopen(path.c_str(), "rb");
+    ASSERT_NE(f, nullptr);
+    std::fseek(f, 0, SEEK_END);
+    const long full = std::ftell(f);
+    std::fclose(f);
+    ASSERT_EQ(truncate(path.c_str(), full - 3), 0);
+
+    HashMap<int, int> loaded;
+    EXPECT_FALSE(loaded.load(path));
+    EXPECT_TRUE(loaded.empty());
+    EXPECT_FALSE(loaded.load(path + ".missing"));
+    std::remove(path.c_str());
+}
+
+namespace
+{
+    /// Writes an "HMSN" header followed by @p count raw (hash, int, int) entries
+    void writeSnapshot(const std::string &path, const uint64_t cap, const uint64_t count,
+                       const std::vector<std::array<uint64_t, 3>> &entries, const float lf = 0.75f)
+    {
+        BinaryWriter out(path);
+        out.writeBytes(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        out.writePod(SNAPSHOT_VERSION);
+        out.writePod(cap);
+        out.writePod(count);
+        out.writePod(lf);
+        for (const auto &[hash, key, value] : entries)
+        {
+            out.writePod(hash);
+            out.writePod(static_cast<int>(key));
+            out.writePod(static_cast<int>(value));
+        }
+        ASSERT_TRUE(out.close());
+    }
+}
+
+TEST(Snapshot, ForeignHashesAreRecomputed)
+{
+    const std::string path = ::testing::TempDir() + "snapshot_foreign.bin";
+    // Stored hashes from another hasher, all in bucket 0; with std::hash the
+    // entries land in buckets 1, 2, 1, 1, not grouped by bucket
+    writeSnapshot(path, 16, 4, {{0, 1, 10}, {16, 2, 20}, {32, 17, 170}, {48, 33, 330}});
+
+    HashMap<int, int> loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.size(), 4);
+    EXPECT_EQ(loaded.get(1), 10);
+    EXPECT_EQ(loaded.get(2), 20);
+    EXPECT_EQ(loaded.get(17), 170);
+    EXPECT_EQ(loaded.get(33), 330);
+    std::remove(path.c_str());
+}
+
+TEST(Snapshot, CorruptSizesFailWithoutAllocating)
+{
+    const std::string path = ::testing::TempDir() + "snapshot_corrupt.bin";
+    HashMap<int, int> loaded;
+
+    // More entries than the file can hold
+    writeSnapshot(path, 16, uint64_t{1} << 60, {{1, 1, 10}});
+    EXPECT_FALSE(loaded.load(path));
+    EXPECT_TRUE(loaded.empty());
+
+    // Huge capacity is clamped to what the file can fill
+    writeSnapshot(path, uint64_t{1} << 62, 1, {{1, 1, 10}});
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.get(1), 10);
+
+    // Load factors that would resize without bound or overflow the threshold
+    for (const float lf : {1e-30f, 0.0f, -0.75f, 1e30f, std::numeric_limits<float>::infinity(),
+                           std::numeric_limits<float>::quiet_NaN()})
+    {
+        writeSnapshot(path, 16, 1, {{1, 1, 10}}, lf);
+        EXPECT_FALSE(loaded.load(path));
+        EXPECT_TRUE(loaded.empty());
+    }
+
+    // String length beyond the end of the file
+    {
+        BinaryWriter out(path);
+        out.writeBytes(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        out.writePod(SNAPSHOT_VERSION);
+        out.writePod(uint64_t{16});
+        out.writePod(uint64_t{1});
+        out.writePod(0.75f);
+        out.writePod(uint64_t{0});
+        out.writeVarint(uint64_t{1} << 62);
+        out.writeBytes("abc", 3);
+        ASSERT_TRUE(out.close());
+    }
+    HashMap<std::string, std::string> strings;
+    EXPECT_FALSE(strings.load(path));
+    EXPECT_TRUE(strings.empty());
+    std::remove(path.c_str());
+}
+
+TEST(Snapshot, ShrunkMapKeepsAllKeys)
+{
+    const std::string path = ::testing::TempDir() + "snapshot_shrunk.bin";
+    // The capacity of the grown map is clamped on load, so keys of different
+    // saved buckets interleave in bucket 5 of the loaded table
+    HashMap<int, int> map;
+    for (int i = 0; i < 200000; ++i) map.put(i, i);
+    map.put(262661, 262661);
+    for (int i = 0; i < 200000; ++i)
+    {
+        if (i != 5 && i != 100 && i != 517) map.remove(i);
+    }
+    ASSERT_EQ(map.size(), 4);
+    ASSERT_TRUE(map.save(path));
+
+    HashMap<int, int> loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.size(), 4);
+    size_t visited = 0;
+    loaded.forEach([&](const int &key, const int &value)
+    {
+        EXPECT_EQ(key, value);
+        ++visited;
+    });
+    EXPECT_EQ(visited, 4);
+    for (const int key : {5, 100, 517, 262661})
+    {
+        EXPECT_EQ(loaded.get(key), key);
+    }
+    std::remove(path.c_str());
+}
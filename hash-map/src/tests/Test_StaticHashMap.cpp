@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string_view>
+#include "StaticHashMap.h"
+
+namespace
+{
+    enum class Color { Red, Green, Blue };
+
+    constexpr auto OPCODES = makeStaticHashMap<std::string_view, int>({
+        {"add", 1}, {"sub", 2}, {"mul", 3}, {"div", 4}, {"mod", 5},
+        {"and", 6}, {"or", 7}, {"xor", 8}, {"not", 9}, {"", 0},
+    });
+
+    constexpr auto COLOR_NAMES = makeStaticHashMap<Color, std::string_view>({
+        {Color::Red, "red"}, {Color::Green, "green"}, {Color::Blue, "blue"},
+    });
+
+    // Built by the compiler, lookups usable in constant expressions
+    static_assert(OPCODES.size() == 10);
+    static_assert(OPCODES.get("xor") == 8);
+    static_assert(OPCODES.get("") == 0);
+    static_assert(!OPCODES.get("nop").has_value());
+    static_assert(COLOR_NAMES.get(Color::Green) == "green");
+}
+
+TEST(StaticHashMap, CompileTimeTables)
+{
+    EXPECT_EQ(OPCODES.get("add"), 1);
+    EXPECT_EQ(OPCODES.get("mod"), 5);
+    EXPECT_EQ(OPCODES.get("ad"), std::nullopt);
+    EXPECT_EQ(OPCODES.get("addd"), std::nullopt);
+    EXPECT_EQ(COLOR_NAMES.get(Color::Blue), "blue");
+
+    int visited = 0;
+    OPCODES.forEach([&](const std::string_view key, const int value)
+    {
+        EXPECT_EQ(OPCODES.get(key), value);
+        ++visited;
+    });
+    EXPECT_EQ(visited, 10);
+}
+
+TEST(StaticHashMap, LargeRuntimeBuild)
+{
+    constexpr size_t n = 5000;
+    std::array<std::pair<uint64_t, uint64_t>, n> entries{};
+    for (size_t i = 0; i < n; ++i) entries[i] = {i * 7919, i};
+    const auto map = std::make_unique<StaticHashMap<uint64_t, uint64_t, n>>(entries);
+    for (size_t i = 0; i < n; ++i) EXPECT_EQ(map->get(i * 7919), i);
+    EXPECT_EQ(map->get(1), std::nullopt);
+    EXPECT_EQ(map->size(), n);
+}
+
+TEST(StaticHashMap, DuplicateKeysThrow)
+{
+    const std::array<std::pair<int, int>, 4> entries{{{1, 10}, {2, 20}, {3, 30}, {2, 21}}};
+    EXPECT_THROW((StaticHashMap<int, int, 4>(entries)), StaticHashMapError);
+    const std::array<std::pair<std::string_view, int>, 2> names{{{"a", 1}, {"a", 2}}};
+    EXPECT_THROW((StaticHashMap<std::string_view, int, 2>(names)), StaticHashMapError);
+}
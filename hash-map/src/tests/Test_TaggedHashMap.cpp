@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "TaggedHashMap.h"
+
+TEST(TaggedHashMap, RemoveRecomputesSummaries)
+{
+    // Identity hash, 16 buckets: one chain 51 -> 35 -> 19 -> 3 in bucket 3
+    TaggedHashMap<int, int> map;
+    for (const int key : {3, 19, 35, 51}) map.put(key, key * 10);
+
+    // Removing from the middle rewrites the summary of 51's link
+    EXPECT_TRUE(map.remove(35));
+    EXPECT_EQ(map.get(35), std::nullopt);
+    EXPECT_EQ(map.get(19), 190);
+    EXPECT_EQ(map.get(3), 30);
+
+    // Removing the head moves the rest of the chain into the bucket slot
+    EXPECT_TRUE(map.remove(51));
+    EXPECT_EQ(map.get(51), std::nullopt);
+    EXPECT_EQ(map.get(19), 190);
+    EXPECT_EQ(map.get(3), 30);
+
+    // Removing the tail ends the chain at 19
+    EXPECT_TRUE(map.remove(3));
+    EXPECT_EQ(map.get(3), std::nullopt);
+    EXPECT_EQ(map.get(19), 190);
+    EXPECT_FALSE(map.remove(3));
+
+    // Reinserting finds no duplicate
+    for (const int key : {3, 35, 51}) map.put(key, key);
+    map.put(19, 19);
+    EXPECT_EQ(map.size(), 4);
+    for (const int key : {3, 19, 35, 51}) EXPECT_EQ(map.get(key), key);
+
+    // A resize relinks every node
+    for (int key = 100; key < 200; ++key) map.put(key, key);
+    for (const int key : {3, 19, 35, 51}) EXPECT_EQ(map.get(key), key);
+    EXPECT_EQ(map.get(67), std::nullopt);
+}
+
+TEST(TaggedHashMap, ChurnWithoutResize)
+{
+    // Constant size, so summaries are only ever rewritten by remove()
+    TaggedHashMap<int, int> map;
+    for (int key = 0; key < 8; ++key) map.put(key * 16, key);
+    for (int step = 8; step < 20000; ++step)
+    {
+        EXPECT_TRUE(map.remove((step - 8) * 16));
+        map.put(step * 16, step);
+    }
+    EXPECT_EQ(map.size(), 8);
+    for (int key = 0; key < 19992; ++key) EXPECT_EQ(map.get(key * 16), std::nullopt);
+    for (int key = 19992; key < 20000; ++key) EXPECT_EQ(map.get(key * 16), key);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include "TextLoader.h"
+
+namespace
+{
+    std::string writeFile(const std::string &name, const std::string &content)
+    {
+        const std::string path = ::testing::TempDir() + name;
+        std::ofstream(path, std::ios::binary) << content;
+        return path;
+    }
+}
+
+TEST(TextLoader, Format)
+{
+    const std::string path = writeFile("loader_format.tsv",
+        "Denis\t23\n"
+        "Anna\t25\r\n"
+        "\n"
+        "no delimiter\n"
+        "empty\t\n"
+        "\tempty key\n"
+        "tabs\tin\tvalue\n"
+        "Denis\t27");
+    HashMap<std::string, std::string> map;
+    map.put("stale", "x");
+    ASSERT_TRUE(loadDelimited(path, map, 1));
+    EXPECT_EQ(map.size(), 5);
+    EXPECT_EQ(map.get("Denis"), "27");
+    EXPECT_EQ(map.get("Anna"), "25");
+    EXPECT_EQ(map.get("empty"), "");
+    EXPECT_EQ(map.get(""), "empty key");
+    EXPECT_EQ(map.get("tabs"), "in\tvalue");
+    EXPECT_EQ(map.get("no delimiter"), std::nullopt);
+    EXPECT_EQ(map.get("stale"), std::nullopt);
+    std::remove(path.c_str());
+}
+
+TEST(TextLoader, ParallelMatchesSequential)
+{
+    std::string content;
+    for (int i = 0; i < 50000; ++i)
+    {
+        content += "key-" + std::to_string(i % 40000) + "\tvalue-" + std::to_string(i) + "\n";
+    }
+    const std::string path = writeFile("loader_parallel.tsv", content);
+
+    for (const size_t threads : {1, 3, 8})
+    {
+        HashMap<std::string, std::string> map;
+        ASSERT_TRUE(loadDelimited(path, map, threads));
+        ASSERT_EQ(map.size(), 40000);
+        // Later lines win over earlier duplicates
+        EXPECT_EQ(map.get("key-5"), "value-40005");
+        EXPECT_EQ(map.get("key-39999"), "value-39999");
+        EXPECT_EQ(map.get("key-10000"), "value-10000");
+        map.put("key-new", "v");
+        EXPECT_EQ(map.get("key-new"), "v");
+        EXPECT_TRUE(map.remove("key-0"));
+        EXPECT_EQ(map.size(), 40000);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(TextLoader, EmptyAndMissing)
+{
+    const std::string path = writeFile("loader_empty.tsv", "");
+    HashMap<std::string, std::string, 4> map;
+    ASSERT_TRUE(loadDelimited(path, map, 2));
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(loadDelimited(path + ".missing", map));
+    std::remove(path.c_str());
+}
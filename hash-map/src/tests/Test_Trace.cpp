@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <unistd.h>
+#include "Trace.h"
+
+TEST(Trace, RecordAndRead)
+{
+    const std::string path = ::testing::TempDir() + "trace_record.bin";
+    {
+        RecordingHashMap<std::string, int> map(path);
+        map.put("Denis", 23);
+        map.put("Anna", 25);
+        EXPECT_EQ(map.get("Denis"), 23);
+        EXPECT_TRUE(map.remove("Anna"));
+        map.clear();
+        EXPECT_EQ(map.size(), 0);
+        ASSERT_TRUE(map.closeTrace());
+    }
+
+    TraceReader<std::string, int> reader(path);
+    const auto records = reader.readAll();
+    ASSERT_TRUE(reader.ok());
+    ASSERT_EQ(records.size(), 5);
+    EXPECT_EQ(records[0].op, TraceOp::Put);
+    EXPECT_EQ(records[0].key, "Denis");
+    EXPECT_EQ(records[0].value, 23);
+    EXPECT_EQ(records[1].op, TraceOp::Put);
+    EXPECT_EQ(records[1].key, "Anna");
+    EXPECT_EQ(records[2].op, TraceOp::Get);
+    EXPECT_EQ(records[2].key, "Denis");
+    EXPECT_EQ(records[3].op, TraceOp::Remove);
+    EXPECT_EQ(records[3].key, "Anna");
+    EXPECT_EQ(records[4].op, TraceOp::Clear);
+    std::remove(path.c_str());
+}
+
+TEST(Trace, TruncatedTrace)
+{
+    const std::string path = ::testing::TempDir() + "trace_truncated.bin";
+    {
+        TraceWriter<int, int> writer(path);
+        writer.put(1, 10);
+        writer.put(2, 20);
+        ASSERT_TRUE(writer.close());
+    }
+    std::FILE *f = std::fopen(path.c_str(), "r+b");
+    ASSERT_NE(f, nullptr);
+    std::fseek(f, 0, SEEK_END);
+    const long full = std::ftell(f);
+    std::fclose(f);
+    ASSERT_EQ(truncate(path.c_str(), full - 2), 0);
+
+    TraceReader<int, int> reader(path);
+    const auto records = reader.readAll();
+    EXPECT_EQ(records.size(), 1);
+    EXPECT_FALSE(reader.ok());
+    std::remove(path.c_str());
+}
+
+TEST(Trace, InvalidHeader)
+{
+    const std::string path = ::testing::TempDir() + "trace_invalid.bin";
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    std::fputs("not a trace", f);
+    std::fclose(f);
+
+    TraceReader<int, int> reader(path);
+    EXPECT_TRUE(reader.readAll().empty());
+    EXPECT_FALSE(reader.ok());
+    std::remove(path.c_str());
+}